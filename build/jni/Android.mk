@@ -12,6 +12,9 @@ LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../ouzel \
     $(LOCAL_PATH)/../../external/khronos
 
 LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
+    ../../ouzel/animators/AnimationClip.cpp \
+    ../../ouzel/animators/AnimationManager.cpp \
+    ../../ouzel/animators/ClipAnimator.cpp \
     ../../ouzel/animators/Ease.cpp \
     ../../ouzel/animators/Fade.cpp \
     ../../ouzel/animators/Move.cpp \
@@ -37,10 +40,14 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/core/Application.cpp \
     ../../ouzel/core/Cache.cpp \
     ../../ouzel/core/Engine.cpp \
+    ../../ouzel/core/FrameAllocator.cpp \
+    ../../ouzel/core/FramePacer.cpp \
+    ../../ouzel/core/JobSystem.cpp \
     ../../ouzel/core/UpdateCallback.cpp \
     ../../ouzel/core/Window.cpp \
     ../../ouzel/events/EventDispatcher.cpp \
     ../../ouzel/events/EventHandler.cpp \
+    ../../ouzel/events/EventQueue.cpp \
     ../../ouzel/files/FileSystem.cpp \
     ../../ouzel/graphics/empty/BlendStateEmpty.cpp \
     ../../ouzel/graphics/empty/BufferEmpty.cpp \
@@ -103,19 +110,28 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/math/Vector4.cpp \
     ../../ouzel/scene/Camera.cpp \
     ../../ouzel/scene/Component.cpp \
+    ../../ouzel/scene/EntityStore.cpp \
     ../../ouzel/scene/Layer.cpp \
+    ../../ouzel/scene/LevelOfDetail.cpp \
     ../../ouzel/scene/Node.cpp \
     ../../ouzel/scene/NodeContainer.cpp \
     ../../ouzel/scene/ParticleDefinition.cpp \
+    ../../ouzel/scene/ParticleManager.cpp \
     ../../ouzel/scene/ParticleSystem.cpp \
     ../../ouzel/scene/Scene.cpp \
     ../../ouzel/scene/SceneManager.cpp \
     ../../ouzel/scene/ShapeDrawable.cpp \
+    ../../ouzel/scene/Skeleton.cpp \
+    ../../ouzel/scene/SkinnedMesh.cpp \
     ../../ouzel/scene/Sprite.cpp \
     ../../ouzel/scene/SpriteFrame.cpp \
+    ../../ouzel/scene/StaticBatch.cpp \
     ../../ouzel/scene/TextDrawable.cpp \
     ../../ouzel/utils/Log.cpp \
+    ../../ouzel/utils/MemoryTracker.cpp \
     ../../ouzel/utils/OBF.cpp \
+    ../../ouzel/utils/ObjectPool.cpp \
+    ../../ouzel/utils/Random.cpp \
     ../../ouzel/utils/Utils.cpp
 
 include $(BUILD_STATIC_LIBRARY)
@@ -0,0 +1,299 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cstring>
+#include "AnimationClip.h"
+#include "core/Application.h"
+#include "files/FileSystem.h"
+#include "utils/Log.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static const uint8_t CLIP_MAGIC[4] = {'O', 'C', 'L', 'P'};
+        static const uint32_t CLIP_VERSION = 1;
+        static const uint32_t CLIP_HEADER_SIZE = 16;
+        static const uint32_t TRACK_HEADER_SIZE = 8;
+        static const uint32_t MAX_CURSOR_STEPS = 4; // keys walked forward before falling back to a binary search
+
+        static float decodeFloatLittle(const uint8_t* buffer)
+        {
+            uint32_t bits = decodeUInt32Little(buffer);
+            float result;
+            memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        static void encodeFloatLittle(uint8_t* buffer, float value)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            encodeUInt32Little(buffer, bits);
+        }
+
+        AnimationClip::AnimationClip()
+        {
+        }
+
+        bool AnimationClip::initFromFile(const std::string& filename)
+        {
+            std::vector<uint8_t> data;
+            if (!sharedApplication->getFileSystem()->readFile(filename, data))
+            {
+                return false;
+            }
+
+            if (!initFromBuffer(data))
+            {
+                Log(Log::Level::ERR) << "Failed to load animation clip " << filename;
+                return false;
+            }
+
+            return true;
+        }
+
+        bool AnimationClip::initFromBuffer(const std::vector<uint8_t>& data)
+        {
+            length = 0.0f;
+            tracks.clear();
+            keyTimes.clear();
+            keyValues.clear();
+            keyInTangents.clear();
+            keyOutTangents.clear();
+
+            if (data.size() < CLIP_HEADER_SIZE ||
+                memcmp(data.data(), CLIP_MAGIC, sizeof(CLIP_MAGIC)) != 0)
+            {
+                Log(Log::Level::ERR) << "Invalid animation clip header";
+                return false;
+            }
+
+            uint32_t version = decodeUInt32Little(data.data() + 4);
+
+            if (version != CLIP_VERSION)
+            {
+                Log(Log::Level::ERR) << "Unsupported animation clip version " << version;
+                return false;
+            }
+
+            float newLength = decodeFloatLittle(data.data() + 8);
+            uint32_t trackCount = decodeUInt32Little(data.data() + 12);
+
+            size_t offset = CLIP_HEADER_SIZE;
+            std::vector<Key> keys;
+
+            for (uint32_t i = 0; i < trackCount; ++i)
+            {
+                if (data.size() - offset < TRACK_HEADER_SIZE)
+                {
+                    Log(Log::Level::ERR) << "Animation clip data is truncated";
+                    return false;
+                }
+
+                uint8_t property = data[offset];
+                uint8_t interpolation = data[offset + 1];
+                uint16_t target = decodeUInt16Little(data.data() + offset + 2);
+                uint32_t keyCount = decodeUInt32Little(data.data() + offset + 4);
+                offset += TRACK_HEADER_SIZE;
+
+                if (property > static_cast<uint8_t>(Property::OPACITY) ||
+                    interpolation > static_cast<uint8_t>(Interpolation::HERMITE))
+                {
+                    Log(Log::Level::ERR) << "Invalid animation clip track";
+                    return false;
+                }
+
+                size_t keySize = (interpolation == static_cast<uint8_t>(Interpolation::HERMITE)) ? 16 : 8;
+
+                if ((data.size() - offset) / keySize < keyCount)
+                {
+                    Log(Log::Level::ERR) << "Animation clip data is truncated";
+                    return false;
+                }
+
+                keys.resize(keyCount);
+
+                for (Key& key : keys)
+                {
+                    key.time = decodeFloatLittle(data.data() + offset);
+                    key.value = decodeFloatLittle(data.data() + offset + 4);
+
+                    if (keySize == 16)
+                    {
+                        key.inTangent = decodeFloatLittle(data.data() + offset + 8);
+                        key.outTangent = decodeFloatLittle(data.data() + offset + 12);
+                    }
+                    else
+                    {
+                        key.inTangent = 0.0f;
+                        key.outTangent = 0.0f;
+                    }
+
+                    offset += keySize;
+                }
+
+                if (!addTrack(static_cast<Property>(property), static_cast<Interpolation>(interpolation), keys, target))
+                {
+                    return false;
+                }
+            }
+
+            length = newLength;
+
+            return true;
+        }
+
+        bool AnimationClip::encode(std::vector<uint8_t>& data) const
+        {
+            data.resize(CLIP_HEADER_SIZE);
+            memcpy(data.data(), CLIP_MAGIC, sizeof(CLIP_MAGIC));
+            encodeUInt32Little(data.data() + 4, CLIP_VERSION);
+            encodeFloatLittle(data.data() + 8, length);
+            encodeUInt32Little(data.data() + 12, static_cast<uint32_t>(tracks.size()));
+
+            for (const Track& track : tracks)
+            {
+                bool hermite = (track.interpolation == Interpolation::HERMITE);
+                size_t offset = data.size();
+                data.resize(offset + TRACK_HEADER_SIZE + track.keyCount * (hermite ? 16 : 8));
+
+                data[offset] = static_cast<uint8_t>(track.property);
+                data[offset + 1] = static_cast<uint8_t>(track.interpolation);
+                encodeUInt16Little(data.data() + offset + 2, track.target);
+                encodeUInt32Little(data.data() + offset + 4, track.keyCount);
+                offset += TRACK_HEADER_SIZE;
+
+                for (uint32_t key = track.firstKey; key < track.firstKey + track.keyCount; ++key)
+                {
+                    encodeFloatLittle(data.data() + offset, keyTimes[key]);
+                    encodeFloatLittle(data.data() + offset + 4, keyValues[key]);
+                    offset += 8;
+
+                    if (hermite)
+                    {
+                        encodeFloatLittle(data.data() + offset, keyInTangents[key]);
+                        encodeFloatLittle(data.data() + offset + 4, keyOutTangents[key]);
+                        offset += 8;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        bool AnimationClip::addTrack(Property property, Interpolation interpolation, const std::vector<Key>& keys, uint16_t target)
+        {
+            if (keys.empty())
+            {
+                Log(Log::Level::ERR) << "Animation clip track has no keys";
+                return false;
+            }
+
+            for (size_t i = 1; i < keys.size(); ++i)
+            {
+                if (keys[i].time < keys[i - 1].time)
+                {
+                    Log(Log::Level::ERR) << "Animation clip keys are not sorted by time";
+                    return false;
+                }
+            }
+
+            Track track;
+            track.property = property;
+            track.interpolation = interpolation;
+            track.target = target;
+            track.firstKey = static_cast<uint32_t>(keyTimes.size());
+            track.keyCount = static_cast<uint32_t>(keys.size());
+            tracks.push_back(track);
+
+            for (const Key& key : keys)
+            {
+                keyTimes.push_back(key.time);
+                keyValues.push_back(key.value);
+                keyInTangents.push_back(key.inTangent);
+                keyOutTangents.push_back(key.outTangent);
+            }
+
+            length = std::max(length, keys.back().time);
+
+            return true;
+        }
+
+        float AnimationClip::sample(uint32_t track, float time, uint32_t& cursor) const
+        {
+            const Track& currentTrack = tracks[track];
+            const float* times = keyTimes.data() + currentTrack.firstKey;
+            const float* values = keyValues.data() + currentTrack.firstKey;
+            uint32_t keyCount = currentTrack.keyCount;
+
+            if (time <= times[0])
+            {
+                cursor = 0;
+                return values[0];
+            }
+
+            if (time >= times[keyCount - 1])
+            {
+                cursor = keyCount - 1;
+                return values[keyCount - 1];
+            }
+
+            uint32_t key = (cursor < keyCount) ? cursor : 0;
+
+            // playing forward usually stays on the same key or moves a few keys ahead, otherwise search
+            if (times[key] > time)
+            {
+                key = static_cast<uint32_t>(std::upper_bound(times, times + key, time) - times) - 1;
+            }
+            else
+            {
+                // time is before the last key, so key + 1 never goes past it
+                for (uint32_t step = 0; step < MAX_CURSOR_STEPS && times[key + 1] <= time; ++step)
+                {
+                    ++key;
+                }
+
+                if (times[key + 1] <= time)
+                {
+                    key = static_cast<uint32_t>(std::upper_bound(times + key, times + keyCount, time) - times) - 1;
+                }
+            }
+
+            cursor = key;
+
+            float value0 = values[key];
+            float value1 = values[key + 1];
+
+            switch (currentTrack.interpolation)
+            {
+                case Interpolation::STEP:
+                    return value0;
+                case Interpolation::LINEAR:
+                {
+                    float t = (time - times[key]) / (times[key + 1] - times[key]);
+                    return value0 + (value1 - value0) * t;
+                }
+                case Interpolation::HERMITE:
+                {
+                    float duration = times[key + 1] - times[key];
+                    float t = (time - times[key]) / duration;
+                    float t2 = t * t;
+                    float t3 = t2 * t;
+
+                    float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+                    float h10 = t3 - 2.0f * t2 + t;
+                    float h01 = -2.0f * t3 + 3.0f * t2;
+                    float h11 = t3 - t2;
+
+                    return h00 * value0 + h10 * duration * keyOutTangents[currentTrack.firstKey + key] +
+                        h01 * value1 + h11 * duration * keyInTangents[currentTrack.firstKey + key + 1];
+                }
+            }
+
+            return value0;
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,91 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Keyframe animation of node properties. A clip is read-only after it is loaded and can be shared by any number
+        // of ClipAnimators, the playback state (time and the key cursor of every track) is stored in the animator.
+        //
+        // Binary format (little endian):
+        //   "OCLP", uint32 version, float length, uint32 track count, for every track:
+        //   uint8 property, uint8 interpolation, uint16 target, uint32 key count,
+        //   for every key: float time, float value and for HERMITE also float in tangent, float out tangent
+        class AnimationClip: public Noncopyable
+        {
+        public:
+            enum class Property: uint8_t
+            {
+                POSITION_X,
+                POSITION_Y,
+                POSITION_Z,
+                ROTATION_X,
+                ROTATION_Y,
+                ROTATION_Z,
+                SCALE_X,
+                SCALE_Y,
+                SCALE_Z,
+                OPACITY
+            };
+
+            enum class Interpolation: uint8_t
+            {
+                STEP,
+                LINEAR,
+                HERMITE
+            };
+
+            struct Key
+            {
+                float time;
+                float value;
+                float inTangent;
+                float outTangent;
+            };
+
+            struct Track
+            {
+                Property property;
+                Interpolation interpolation;
+                uint16_t target; // bone index for skeletal animation, not used by ClipAnimator
+                uint32_t firstKey;
+                uint32_t keyCount;
+            };
+
+            AnimationClip();
+
+            bool initFromFile(const std::string& filename);
+            bool initFromBuffer(const std::vector<uint8_t>& data);
+            bool encode(std::vector<uint8_t>& data) const;
+
+            // keys must be sorted by time
+            bool addTrack(Property property, Interpolation interpolation, const std::vector<Key>& keys, uint16_t target = 0);
+
+            float getLength() const { return length; }
+            void setLength(float newLength) { length = newLength; }
+
+            const std::vector<Track>& getTracks() const { return tracks; }
+
+            // samples the track at the given time, the cursor is the key index found by the previous sample,
+            // so playing the clip forward costs O(1) per sample
+            float sample(uint32_t track, float time, uint32_t& cursor) const;
+
+        protected:
+            float length = 0.0f;
+            std::vector<Track> tracks;
+
+            std::vector<float> keyTimes;
+            std::vector<float> keyValues;
+            std::vector<float> keyInTangents;
+            std::vector<float> keyOutTangents;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,448 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "AnimationManager.h"
+#include "Animator.h"
+#include "core/Engine.h"
+#include "scene/Node.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        AnimationManager::AnimationManager()
+        {
+            updateCallback.callback = std::bind(&AnimationManager::update, this, std::placeholders::_1);
+        }
+
+        AnimationManager::~AnimationManager()
+        {
+            if (scheduled && sharedEngine) sharedEngine->unscheduleUpdate(&updateCallback);
+        }
+
+        void AnimationManager::addAnimation(Node* node, Animator* animator)
+        {
+            removeAnimation(animator);
+
+            Animation animation;
+            animation.animator = animator;
+            animation.node = node;
+            animation.time = animator->currentTime;
+            animation.progress = animator->progress;
+            animation.looping = false;
+            animation.updated = false;
+            animation.invalid = false;
+
+            currentAnimation = static_cast<uint32_t>(animations.size());
+            animations.push_back(animation);
+            animators.push_back(animator);
+
+            mappingStack.clear();
+            animator->compile(*this);
+
+            if (!scheduled)
+            {
+                sharedEngine->scheduleUpdate(&updateCallback);
+                scheduled = true;
+            }
+        }
+
+        void AnimationManager::removeAnimation(Animator* animator)
+        {
+            if (!animator) return;
+
+            // entries are only cleared here, because this can be called from finish handlers
+            auto i = std::find(animators.begin(), animators.end(), animator);
+
+            if (i != animators.end())
+            {
+                *i = nullptr;
+                animations[static_cast<size_t>(i - animators.begin())].animator = nullptr;
+                ++removedCount;
+            }
+        }
+
+        void AnimationManager::invalidateAnimation(Animator* animator)
+        {
+            if (!animator) return;
+
+            auto i = std::find(animators.begin(), animators.end(), animator);
+
+            if (i != animators.end())
+            {
+                animations[static_cast<size_t>(i - animators.begin())].invalid = true;
+                invalidated = true;
+            }
+        }
+
+        uint32_t AnimationManager::getTrackCount() const
+        {
+            return static_cast<uint32_t>(moveTracks.size() + rotateTracks.size() + scaleTracks.size() +
+                                         fadeTracks.size() + animatorTracks.size());
+        }
+
+        void AnimationManager::pushSequence(float offset, float length)
+        {
+            TimeMapping mapping;
+            mapping.type = TimeMapping::Type::SEQUENCE;
+            mapping.offset = offset;
+            mapping.length = length;
+            mapping.count = 0;
+            mappingStack.push_back(mapping);
+        }
+
+        void AnimationManager::pushParallel(float length)
+        {
+            TimeMapping mapping;
+            mapping.type = TimeMapping::Type::PARALLEL;
+            mapping.offset = 0.0f;
+            mapping.length = length;
+            mapping.count = 0;
+            mappingStack.push_back(mapping);
+        }
+
+        void AnimationManager::pushRepeat(float length, uint32_t count)
+        {
+            // an endless repeat at the root keeps the animation running forever
+            if (mappingStack.empty() && count == 0)
+            {
+                animations[currentAnimation].looping = true;
+            }
+
+            TimeMapping mapping;
+            mapping.type = TimeMapping::Type::REPEAT;
+            mapping.offset = 0.0f;
+            mapping.length = length;
+            mapping.count = count;
+            mappingStack.push_back(mapping);
+        }
+
+        void AnimationManager::pushEase(Ease::Type type, Ease::Func func, float length)
+        {
+            TimeMapping mapping;
+            mapping.type = TimeMapping::Type::EASE;
+            mapping.offset = 0.0f;
+            mapping.length = length;
+            mapping.count = 0;
+            mapping.easeType = type;
+            mapping.easeFunc = func;
+            mappingStack.push_back(mapping);
+        }
+
+        void AnimationManager::popTimeMapping()
+        {
+            mappingStack.pop_back();
+        }
+
+        AnimationManager::Track AnimationManager::createTrack()
+        {
+            Track track;
+            track.animation = currentAnimation;
+            track.firstMapping = static_cast<uint32_t>(timeMappings.size());
+            track.mappingCount = static_cast<uint32_t>(mappingStack.size());
+            track.progress = std::numeric_limits<float>::quiet_NaN();
+
+            timeMappings.insert(timeMappings.end(), mappingStack.begin(), mappingStack.end());
+
+            return track;
+        }
+
+        void AnimationManager::addMoveTrack(Node* node, const Vector3& start, const Vector3& diff)
+        {
+            VectorTrack track;
+            static_cast<Track&>(track) = createTrack();
+            track.node = node;
+            track.start = start;
+            track.diff = diff;
+            moveTracks.push_back(track);
+        }
+
+        void AnimationManager::addRotateTrack(Node* node, const Vector3& start, const Vector3& diff)
+        {
+            VectorTrack track;
+            static_cast<Track&>(track) = createTrack();
+            track.node = node;
+            track.start = start;
+            track.diff = diff;
+            rotateTracks.push_back(track);
+        }
+
+        void AnimationManager::addScaleTrack(Node* node, const Vector3& start, const Vector3& diff)
+        {
+            VectorTrack track;
+            static_cast<Track&>(track) = createTrack();
+            track.node = node;
+            track.start = start;
+            track.diff = diff;
+            scaleTracks.push_back(track);
+        }
+
+        void AnimationManager::addFadeTrack(Node* node, float start, float diff)
+        {
+            FadeTrack track;
+            static_cast<Track&>(track) = createTrack();
+            track.node = node;
+            track.start = start;
+            track.diff = diff;
+            fadeTracks.push_back(track);
+        }
+
+        void AnimationManager::addAnimatorTrack(Animator* animator)
+        {
+            AnimatorTrack track;
+            static_cast<Track&>(track) = createTrack();
+            track.animator = animator;
+            animatorTracks.push_back(track);
+        }
+
+        float AnimationManager::getProgress(const Track& track) const
+        {
+            const Animation& animation = animations[track.animation];
+
+            float time = animation.time;
+            float progress = animation.progress;
+
+            const TimeMapping* mapping = timeMappings.data() + track.firstMapping;
+
+            for (uint32_t i = 0; i < track.mappingCount; ++i, ++mapping)
+            {
+                switch (mapping->type)
+                {
+                    case TimeMapping::Type::SEQUENCE:
+                        if (mapping->length <= 0.0f || time > mapping->offset + mapping->length) progress = 1.0f;
+                        else if (time <= mapping->offset) progress = 0.0f;
+                        else progress = (time - mapping->offset) / mapping->length;
+                        break;
+                    case TimeMapping::Type::PARALLEL:
+                        if (mapping->length <= 0.0f || time > mapping->length) progress = 1.0f;
+                        else progress = time / mapping->length;
+                        break;
+                    case TimeMapping::Type::REPEAT:
+                    {
+                        if (mapping->length <= 0.0f)
+                        {
+                            progress = 1.0f;
+                        }
+                        else
+                        {
+                            float count = std::max(std::floor(time / mapping->length), 0.0f);
+
+                            if (mapping->count == 0 || count < static_cast<float>(mapping->count))
+                            {
+                                progress = (time - mapping->length * count) / mapping->length;
+                            }
+                            else
+                            {
+                                progress = 1.0f;
+                            }
+                        }
+                        break;
+                    }
+                    case TimeMapping::Type::EASE:
+                        progress = Ease::ease(mapping->easeType, mapping->easeFunc, progress);
+                        break;
+                }
+
+                time = progress * mapping->length;
+            }
+
+            return progress;
+        }
+
+        void AnimationManager::update(float delta)
+        {
+            if (invalidated) recompile();
+            if (removedCount) compact();
+
+            finishedAnimations.clear();
+
+            for (uint32_t i = 0; i < animations.size(); ++i)
+            {
+                Animation& animation = animations[i];
+                Animator* animator = animation.animator;
+
+                animation.updated = animator && animator->running;
+
+                if (animation.updated)
+                {
+                    if (!animation.looping && animator->currentTime + delta >= animator->length)
+                    {
+                        animator->done = true;
+                        animator->running = false;
+                        animator->progress = 1.0f;
+                        animator->currentTime = animator->length;
+                        finishedAnimations.push_back(i);
+                    }
+                    else
+                    {
+                        animator->currentTime += delta;
+                        animator->progress = (animator->length > 0.0f) ? animator->currentTime / animator->length : 0.0f;
+                    }
+
+                    animation.time = animator->currentTime;
+                    animation.progress = animator->progress;
+                }
+            }
+
+            for (VectorTrack& track : moveTracks)
+            {
+                if (animations[track.animation].updated)
+                {
+                    float progress = getProgress(track);
+
+                    if (progress != track.progress)
+                    {
+                        track.progress = progress;
+                        track.node->setPosition(track.start + track.diff * progress);
+                    }
+                }
+            }
+
+            for (VectorTrack& track : rotateTracks)
+            {
+                if (animations[track.animation].updated)
+                {
+                    float progress = getProgress(track);
+
+                    if (progress != track.progress)
+                    {
+                        track.progress = progress;
+                        track.node->setRotation(track.start + track.diff * progress);
+                    }
+                }
+            }
+
+            for (VectorTrack& track : scaleTracks)
+            {
+                if (animations[track.animation].updated)
+                {
+                    float progress = getProgress(track);
+
+                    if (progress != track.progress)
+                    {
+                        track.progress = progress;
+                        track.node->setScale(track.start + track.diff * progress);
+                    }
+                }
+            }
+
+            for (FadeTrack& track : fadeTracks)
+            {
+                if (animations[track.animation].updated)
+                {
+                    float progress = getProgress(track);
+
+                    if (progress != track.progress)
+                    {
+                        track.progress = progress;
+                        track.node->setOpacity(track.start + track.diff * progress);
+                    }
+                }
+            }
+
+            for (const AnimatorTrack& track : animatorTracks)
+            {
+                if (animations[track.animation].updated)
+                {
+                    track.animator->setProgress(getProgress(track));
+                }
+            }
+
+            // finish handlers can add and remove animations, so the entries are accessed by index
+            for (uint32_t index : finishedAnimations)
+            {
+                Animator* animator = animations[index].animator;
+
+                if (animator)
+                {
+                    if (animator->finishHandler) animator->finishHandler();
+
+                    if (animations[index].animator == animator)
+                    {
+                        Node* node = animations[index].node;
+                        removeAnimation(animator);
+                        node->removeAnimator(animator);
+                    }
+                }
+            }
+        }
+
+        void AnimationManager::recompile()
+        {
+            invalidated = false;
+
+            // addAnimation appends the new entries, so only the existing ones are visited
+            size_t count = animations.size();
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (animations[i].animator && animations[i].invalid)
+                {
+                    addAnimation(animations[i].node, animations[i].animator);
+                }
+            }
+        }
+
+        template<class T>
+        void AnimationManager::compactTracks(std::vector<T>& tracks, const std::vector<uint32_t>& remap,
+                                             std::vector<TimeMapping>& newTimeMappings)
+        {
+            uint32_t count = 0;
+
+            for (const T& track : tracks)
+            {
+                uint32_t animation = remap[track.animation];
+
+                if (animation != UINT32_MAX)
+                {
+                    T newTrack = track;
+                    newTrack.animation = animation;
+                    newTrack.firstMapping = static_cast<uint32_t>(newTimeMappings.size());
+
+                    newTimeMappings.insert(newTimeMappings.end(),
+                                           timeMappings.begin() + track.firstMapping,
+                                           timeMappings.begin() + track.firstMapping + track.mappingCount);
+
+                    tracks[count++] = newTrack;
+                }
+            }
+
+            tracks.resize(count);
+        }
+
+        void AnimationManager::compact()
+        {
+            std::vector<uint32_t> remap(animations.size(), UINT32_MAX);
+            uint32_t count = 0;
+
+            for (uint32_t i = 0; i < animations.size(); ++i)
+            {
+                if (animations[i].animator)
+                {
+                    remap[i] = count;
+                    animations[count] = animations[i];
+                    animators[count] = animators[i];
+                    ++count;
+                }
+            }
+
+            animations.resize(count);
+            animators.resize(count);
+            removedCount = 0;
+
+            std::vector<TimeMapping> newTimeMappings;
+            newTimeMappings.reserve(timeMappings.size());
+
+            compactTracks(moveTracks, remap, newTimeMappings);
+            compactTracks(rotateTracks, remap, newTimeMappings);
+            compactTracks(scaleTracks, remap, newTimeMappings);
+            compactTracks(fadeTracks, remap, newTimeMappings);
+            compactTracks(animatorTracks, remap, newTimeMappings);
+
+            timeMappings.swap(newTimeMappings);
+        }
+    } // namespace scene
+} // namespace ouzel
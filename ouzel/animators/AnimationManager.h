@@ -0,0 +1,142 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "utils/Noncopyable.h"
+#include "core/UpdateCallback.h"
+#include "animators/Ease.h"
+#include "math/Vector3.h"
+
+namespace ouzel
+{
+    class Engine;
+
+    namespace scene
+    {
+        class Animator;
+        class Node;
+
+        // Updates the animators of all nodes once per frame.
+        // Animator trees are compiled into flat, per type arrays of tracks when they are started. Every track stores the chain
+        // of time mappings (sequence offsets, parallel spans, repeats and easing) from the root animator to the tween.
+        class AnimationManager: public Noncopyable
+        {
+            friend Engine;
+        public:
+            virtual ~AnimationManager();
+
+            void addAnimation(Node* node, Animator* animator);
+            void removeAnimation(Animator* animator);
+            // the tracks hold pointers into the animator tree, so they are compiled again before the next update
+            void invalidateAnimation(Animator* animator);
+
+            uint32_t getAnimationCount() const { return static_cast<uint32_t>(animations.size()) - removedCount; }
+            uint32_t getTrackCount() const;
+
+            // called by Animator::compile
+            void pushSequence(float offset, float length);
+            void pushParallel(float length);
+            void pushRepeat(float length, uint32_t count);
+            void pushEase(Ease::Type type, Ease::Func func, float length);
+            void popTimeMapping();
+
+            void addMoveTrack(Node* node, const Vector3& start, const Vector3& diff);
+            void addRotateTrack(Node* node, const Vector3& start, const Vector3& diff);
+            void addScaleTrack(Node* node, const Vector3& start, const Vector3& diff);
+            void addFadeTrack(Node* node, float start, float diff);
+            // for animators that have no compiled form, progress is set through Animator::setProgress
+            void addAnimatorTrack(Animator* animator);
+
+        protected:
+            AnimationManager();
+
+            void update(float delta);
+            void recompile();
+            void compact();
+
+            struct TimeMapping
+            {
+                enum class Type
+                {
+                    SEQUENCE,
+                    PARALLEL,
+                    REPEAT,
+                    EASE
+                };
+
+                Type type;
+                float offset;
+                float length; // length of the child animator
+                uint32_t count;
+                Ease::Type easeType;
+                Ease::Func easeFunc;
+            };
+
+            struct Animation
+            {
+                Animator* animator;
+                Node* node;
+                float time;
+                float progress;
+                bool looping;
+                bool updated;
+                bool invalid;
+            };
+
+            struct Track
+            {
+                uint32_t animation;
+                uint32_t firstMapping;
+                uint32_t mappingCount;
+                float progress; // last applied progress, NaN until the track is first applied
+            };
+
+            struct VectorTrack: Track
+            {
+                Node* node;
+                Vector3 start;
+                Vector3 diff;
+            };
+
+            struct FadeTrack: Track
+            {
+                Node* node;
+                float start;
+                float diff;
+            };
+
+            struct AnimatorTrack: Track
+            {
+                Animator* animator;
+            };
+
+            Track createTrack();
+            float getProgress(const Track& track) const;
+            template<class T> void compactTracks(std::vector<T>& tracks, const std::vector<uint32_t>& remap,
+                                                 std::vector<TimeMapping>& newTimeMappings);
+
+            std::vector<Animation> animations;
+            std::vector<Animator*> animators; // same order as animations, for lookups
+            uint32_t removedCount = 0;
+            bool invalidated = false;
+
+            std::vector<TimeMapping> timeMappings;
+            std::vector<TimeMapping> mappingStack;
+            uint32_t currentAnimation = 0;
+
+            std::vector<VectorTrack> moveTracks;
+            std::vector<VectorTrack> rotateTracks;
+            std::vector<VectorTrack> scaleTracks;
+            std::vector<FadeTrack> fadeTracks;
+            std::vector<AnimatorTrack> animatorTracks;
+
+            std::vector<uint32_t> finishedAnimations;
+
+            UpdateCallback updateCallback;
+            bool scheduled = false;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -5,6 +5,7 @@
 #include "utils/Utils.h"
 #include "core/Engine.h"
 #include "scene/Node.h"
+#include "AnimationManager.h"
 
 namespace ouzel
 {
@@ -89,6 +90,11 @@ namespace ouzel
         {
         }
 
+        void Animator::compile(AnimationManager& manager)
+        {
+            manager.addAnimatorTrack(this);
+        }
+
         void Animator::removeFromParent()
         {
             if (parent)
@@ -101,6 +107,11 @@ namespace ouzel
         void Animator::removeAnimator(Animator* animator)
         {
             if (animator->parent == this) animator->parent = nullptr;
+
+            Animator* root = this;
+            while (root->parent) root = root->parent;
+
+            if (root->parentNode) sharedEngine->getAnimationManager()->invalidateAnimation(root);
         }
     } // namespace scene
 } // namespace ouzel
@@ -10,11 +10,13 @@ namespace ouzel
 {
     namespace scene
     {
+        class AnimationManager;
         class Node;
 
         class Animator: public Noncopyable
         {
             friend Node;
+            friend AnimationManager;
         public:
             Animator(float aLength);
             virtual ~Animator();
@@ -22,6 +24,8 @@ namespace ouzel
             virtual void update(float delta);
 
             virtual void start(Node* newTargetNode);
+            // adds the tracks of the animator to the animation manager, animators without a compiled form are updated through setProgress
+            virtual void compile(AnimationManager& manager);
 
             virtual void resume();
             virtual void stop(bool resetAnimation = false);
@@ -0,0 +1,108 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "ClipAnimator.h"
+#include "scene/Node.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        ClipAnimator::ClipAnimator(const std::shared_ptr<AnimationClip>& aClip, bool aRelative):
+            Animator(aClip ? aClip->getLength() : 0.0f), clip(aClip), relative(aRelative)
+        {
+            if (clip)
+            {
+                cursors.resize(clip->getTracks().size(), 0);
+            }
+        }
+
+        void ClipAnimator::start(Node* newTargetNode)
+        {
+            Animator::start(newTargetNode);
+
+            if (targetNode)
+            {
+                startPosition = targetNode->getPosition();
+                startRotation = targetNode->getRotation().getEulerAngles();
+                startScale = targetNode->getScale();
+                startOpacity = targetNode->getOpacity();
+            }
+        }
+
+        void ClipAnimator::reset()
+        {
+            std::fill(cursors.begin(), cursors.end(), 0);
+
+            Animator::reset();
+        }
+
+        void ClipAnimator::updateProgress()
+        {
+            Animator::updateProgress();
+
+            if (!targetNode || !clip)
+            {
+                return;
+            }
+
+            Vector3 position = startPosition;
+            Vector3 rotation = startRotation;
+            Vector3 scale = startScale;
+            float opacity = startOpacity;
+
+            bool positionChanged = false;
+            bool rotationChanged = false;
+            bool scaleChanged = false;
+            bool opacityChanged = false;
+
+            const std::vector<AnimationClip::Track>& tracks = clip->getTracks();
+
+            for (uint32_t i = 0; i < tracks.size(); ++i)
+            {
+                float value = clip->sample(i, currentTime, cursors[i]);
+
+                switch (tracks[i].property)
+                {
+                    case AnimationClip::Property::POSITION_X:
+                    case AnimationClip::Property::POSITION_Y:
+                    case AnimationClip::Property::POSITION_Z:
+                    {
+                        uint32_t component = static_cast<uint32_t>(tracks[i].property) - static_cast<uint32_t>(AnimationClip::Property::POSITION_X);
+                        position.v[component] = relative ? startPosition.v[component] + value : value;
+                        positionChanged = true;
+                        break;
+                    }
+                    case AnimationClip::Property::ROTATION_X:
+                    case AnimationClip::Property::ROTATION_Y:
+                    case AnimationClip::Property::ROTATION_Z:
+                    {
+                        uint32_t component = static_cast<uint32_t>(tracks[i].property) - static_cast<uint32_t>(AnimationClip::Property::ROTATION_X);
+                        rotation.v[component] = relative ? startRotation.v[component] + value : value;
+                        rotationChanged = true;
+                        break;
+                    }
+                    case AnimationClip::Property::SCALE_X:
+                    case AnimationClip::Property::SCALE_Y:
+                    case AnimationClip::Property::SCALE_Z:
+                    {
+                        uint32_t component = static_cast<uint32_t>(tracks[i].property) - static_cast<uint32_t>(AnimationClip::Property::SCALE_X);
+                        scale.v[component] = relative ? startScale.v[component] + value : value;
+                        scaleChanged = true;
+                        break;
+                    }
+                    case AnimationClip::Property::OPACITY:
+                        opacity = relative ? startOpacity + value : value;
+                        opacityChanged = true;
+                        break;
+                }
+            }
+
+            if (positionChanged) targetNode->setPosition(position);
+            if (rotationChanged) targetNode->setRotation(rotation);
+            if (scaleChanged) targetNode->setScale(scale);
+            if (opacityChanged) targetNode->setOpacity(opacity);
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,40 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "animators/Animator.h"
+#include "animators/AnimationClip.h"
+#include "math/Vector3.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class ClipAnimator: public Animator
+        {
+        public:
+            ClipAnimator(const std::shared_ptr<AnimationClip>& aClip, bool aRelative = false);
+
+            virtual void start(Node* newTargetNode) override;
+            virtual void reset() override;
+
+            const std::shared_ptr<AnimationClip>& getClip() const { return clip; }
+
+        protected:
+            virtual void updateProgress() override;
+
+            std::shared_ptr<AnimationClip> clip;
+            bool relative;
+
+            std::vector<uint32_t> cursors;
+
+            Vector3 startPosition;
+            Vector3 startRotation;
+            Vector3 startScale;
+            float startOpacity = 1.0f;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -1,9 +1,20 @@
 // Copyright (C) 2017 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <vector>
+#include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE2
+#include <emmintrin.h>
+#endif
 #include "Ease.h"
+#include "AnimationManager.h"
 #include "math/MathUtils.h"
+#include "utils/Utils.h"
 
 namespace ouzel
 {
@@ -120,7 +131,7 @@ namespace ouzel
             if (t < 0.5f)
                 return 0.5f * powf(2.0f, 10.0f * (2.0f * t - 1.0f));
             else
-                return 0.5f * (powf(2.0f, -10.0f * (t * 2.0f - 1.0f)) - 2.0f);
+                return 0.5f * (2.0f - powf(2.0f, -10.0f * (t * 2.0f - 1.0f)));
         }
 
         static float circIn(float t)
@@ -253,38 +264,10 @@ namespace ouzel
                 return bounceOut(t * 2.0f - 1.0f) * 0.5f + 0.5f;
         }
 
-        Ease::Ease(Animator* aAnimator, Type aType, Func aFunc):
-            Animator(aAnimator->getLength()), animator(aAnimator), type(aType), func(aFunc)
-        {
-        }
-
-        void Ease::start(Node* newTargetNode)
-        {
-            Animator::start(newTargetNode);
-
-            animator->start(targetNode);
-        }
-
-        void Ease::reset()
-        {
-            Animator::reset();
-
-            animator->reset();
-        }
-
-        void Ease::removeAnimator(Animator* oldAnimator)
-        {
-            Animator::removeAnimator(oldAnimator);
-
-            if (oldAnimator == animator)
-            {
-                animator = nullptr;
-            }
-        }
-
-        void Ease::updateProgress()
+        static float evaluate(Ease::Type type, Ease::Func func, float progress)
         {
-            Animator::updateProgress();
+            typedef Ease::Type Type;
+            typedef Ease::Func Func;
 
             switch (type)
             {
@@ -314,7 +297,7 @@ namespace ouzel
                         case Func::QUAD: progress = quadOut(progress); break;
                         case Func::CUBIC: progress = cubicOut(progress); break;
                         case Func::QUART: progress = quartOut(progress); break;
-                        case Func::QUINT: quintOut(progress); break;
+                        case Func::QUINT: progress = quintOut(progress); break;
                         case Func::EXPO: progress = expoOut(progress); break;
                         case Func::CIRC: progress = circOut(progress); break;
                         case Func::BACK: progress = backOut(progress); break;
@@ -343,7 +326,227 @@ namespace ouzel
                 }
             }
 
+            return progress;
+        }
+
+        // number of linear segments per curve
+        static const uint32_t LOOKUP_TABLE_SIZE = 1024;
+        static const uint32_t TYPE_COUNT = 3;
+        static const uint32_t FUNC_COUNT = 10;
+
+        static bool lookupTablesEnabled = false;
+        static std::once_flag lookupTablesFlag;
+        static std::vector<float> lookupTables;
+
+        static void createLookupTables()
+        {
+            std::call_once(lookupTablesFlag, []() {
+                lookupTables.resize(TYPE_COUNT * FUNC_COUNT * (LOOKUP_TABLE_SIZE + 1));
+                float* value = lookupTables.data();
+
+                for (uint32_t t = 0; t < TYPE_COUNT; ++t)
+                {
+                    for (uint32_t f = 0; f < FUNC_COUNT; ++f)
+                    {
+                        for (uint32_t i = 0; i <= LOOKUP_TABLE_SIZE; ++i)
+                        {
+                            *value++ = evaluate(static_cast<Ease::Type>(t), static_cast<Ease::Func>(f),
+                                                static_cast<float>(i) / static_cast<float>(LOOKUP_TABLE_SIZE));
+                        }
+                    }
+                }
+            });
+        }
+
+        static const float* getLookupTable(Ease::Type type, Ease::Func func)
+        {
+            uint32_t index = static_cast<uint32_t>(type) * FUNC_COUNT + static_cast<uint32_t>(func);
+            return lookupTables.data() + index * (LOOKUP_TABLE_SIZE + 1);
+        }
+
+        static float sample(const float* table, Ease::Type type, Ease::Func func, float progress)
+        {
+            // values outside of the table range (overshooting nested easing) are evaluated exactly
+            if (progress < 0.0f || progress > 1.0f)
+            {
+                return evaluate(type, func, progress);
+            }
+
+            float scaled = progress * static_cast<float>(LOOKUP_TABLE_SIZE);
+            uint32_t index = std::min(static_cast<uint32_t>(scaled), LOOKUP_TABLE_SIZE - 1);
+            float t = scaled - static_cast<float>(index);
+
+            return table[index] + (table[index + 1] - table[index]) * t;
+        }
+
+        Ease::Ease(Animator* aAnimator, Type aType, Func aFunc):
+            Animator(aAnimator->getLength()), animator(aAnimator), type(aType), func(aFunc)
+        {
+        }
+
+        void Ease::setLookupTablesEnabled(bool enabled)
+        {
+            if (enabled) createLookupTables();
+            lookupTablesEnabled = enabled;
+        }
+
+        bool Ease::isLookupTablesEnabled()
+        {
+            return lookupTablesEnabled;
+        }
+
+        float Ease::ease(Type type, Func func, float progress)
+        {
+            // polynomial curves are cheaper to evaluate than to look up
+            if (lookupTablesEnabled &&
+                (func == Func::SINE || func == Func::EXPO || func == Func::CIRC || func == Func::ELASTIC || func == Func::BOUNCE))
+            {
+                return sample(getLookupTable(type, func), type, func, progress);
+            }
+            else
+            {
+                return evaluate(type, func, progress);
+            }
+        }
+
+        void Ease::ease(Type type, Func func, const float* progresses, float* results, uint32_t count)
+        {
+            createLookupTables();
+
+            const float* table = getLookupTable(type, func);
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                float32x4_t zero = vdupq_n_f32(0.0f);
+                float32x4_t one = vdupq_n_f32(1.0f);
+                float32x4_t maxIndex = vdupq_n_f32(static_cast<float>(LOOKUP_TABLE_SIZE - 1));
+                int32_t indices[4];
+                float lower[4];
+                float upper[4];
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    float32x4_t x = vld1q_f32(progresses + i);
+
+                    uint32x4_t outside = vorrq_u32(vcltq_f32(x, zero), vcgtq_f32(x, one));
+                    uint32x2_t folded = vorr_u32(vget_low_u32(outside), vget_high_u32(outside));
+
+                    if (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1))
+                    {
+                        for (uint32_t j = i; j < i + 4; ++j)
+                        {
+                            results[j] = sample(table, type, func, progresses[j]);
+                        }
+                        continue;
+                    }
+
+                    float32x4_t scaled = vmulq_n_f32(x, static_cast<float>(LOOKUP_TABLE_SIZE));
+                    int32x4_t index = vcvtq_s32_f32(vminq_f32(scaled, maxIndex));
+                    float32x4_t t = vsubq_f32(scaled, vcvtq_f32_s32(index));
+
+                    vst1q_s32(indices, index);
+
+                    for (uint32_t j = 0; j < 4; ++j)
+                    {
+                        lower[j] = table[indices[j]];
+                        upper[j] = table[indices[j] + 1];
+                    }
+
+                    float32x4_t a = vld1q_f32(lower);
+                    float32x4_t b = vld1q_f32(upper);
+                    vst1q_f32(results + i, vmlaq_f32(a, vsubq_f32(b, a), t));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE2
+            __m128 zero = _mm_setzero_ps();
+            __m128 one = _mm_set1_ps(1.0f);
+            __m128 maxIndex = _mm_set1_ps(static_cast<float>(LOOKUP_TABLE_SIZE - 1));
+            alignas(16) int32_t indices[4];
+            alignas(16) float lower[4];
+            alignas(16) float upper[4];
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x = _mm_loadu_ps(progresses + i);
+
+                if (_mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(x, zero), _mm_cmpgt_ps(x, one))))
+                {
+                    for (uint32_t j = i; j < i + 4; ++j)
+                    {
+                        results[j] = sample(table, type, func, progresses[j]);
+                    }
+                    continue;
+                }
+
+                __m128 scaled = _mm_mul_ps(x, _mm_set1_ps(static_cast<float>(LOOKUP_TABLE_SIZE)));
+                __m128i index = _mm_cvttps_epi32(_mm_min_ps(scaled, maxIndex));
+                __m128 t = _mm_sub_ps(scaled, _mm_cvtepi32_ps(index));
+
+                _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+
+                for (uint32_t j = 0; j < 4; ++j)
+                {
+                    lower[j] = table[indices[j]];
+                    upper[j] = table[indices[j] + 1];
+                }
+
+                __m128 a = _mm_load_ps(lower);
+                __m128 b = _mm_load_ps(upper);
+                _mm_storeu_ps(results + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                results[i] = sample(table, type, func, progresses[i]);
+            }
+        }
+
+        void Ease::start(Node* newTargetNode)
+        {
+            Animator::start(newTargetNode);
+
+            animator->start(targetNode);
+        }
+
+        void Ease::reset()
+        {
+            Animator::reset();
+
+            animator->reset();
+        }
+
+        void Ease::removeAnimator(Animator* oldAnimator)
+        {
+            Animator::removeAnimator(oldAnimator);
+
+            if (oldAnimator == animator)
+            {
+                animator = nullptr;
+            }
+        }
+
+
+        void Ease::updateProgress()
+        {
+            Animator::updateProgress();
+
+            progress = ease(type, func, progress);
             animator->setProgress(progress);
         }
+
+        void Ease::compile(AnimationManager& manager)
+        {
+            if (animator)
+            {
+                manager.pushEase(type, func, animator->getLength());
+                animator->compile(manager);
+                manager.popTimeMapping();
+            }
+        }
     } // namespace scene
 } // namespace ouzel
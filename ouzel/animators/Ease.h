@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include "animators/Animator.h"
 
 namespace ouzel
@@ -35,8 +36,17 @@ namespace ouzel
 
             Ease(Animator* aAnimator, Type aType, Func aFunc);
 
+            // when enabled, curves with transcendental functions are sampled from precomputed tables with linear interpolation
+            static void setLookupTablesEnabled(bool enabled);
+            static bool isLookupTablesEnabled();
+
+            static float ease(Type type, Func func, float progress);
+            // evaluates count progress values at once, always from the lookup tables
+            static void ease(Type type, Func func, const float* progresses, float* results, uint32_t count);
+
             virtual void start(Node* newTargetNode) override;
             virtual void reset() override;
+            virtual void compile(AnimationManager& manager) override;
 
         protected:
             virtual void removeAnimator(Animator* oldAnimator) override;
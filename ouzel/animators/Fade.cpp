@@ -2,6 +2,7 @@
 // This file is part of the Ouzel engine.
 
 #include "Fade.h"
+#include "AnimationManager.h"
 #include "scene/Node.h"
 
 namespace ouzel
@@ -35,5 +36,13 @@ namespace ouzel
                 targetNode->setOpacity(startOpacity + (diff * progress));
             }
         }
+
+        void Fade::compile(AnimationManager& manager)
+        {
+            if (targetNode)
+            {
+                manager.addFadeTrack(targetNode, startOpacity, diff);
+            }
+        }
     } // namespace scene
 } // namespace ouzel
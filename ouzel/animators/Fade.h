@@ -15,6 +15,7 @@ namespace ouzel
             Fade(float aLength, float aOpacity, bool aRelative = false);
 
             virtual void start(Node* newTargetNode) override;
+            virtual void compile(AnimationManager& manager) override;
 
         protected:
             virtual void updateProgress() override;
@@ -2,6 +2,7 @@
 // This file is part of the Ouzel engine.
 
 #include "Move.h"
+#include "AnimationManager.h"
 #include "scene/Node.h"
 
 namespace ouzel
@@ -35,5 +36,13 @@ namespace ouzel
                 targetNode->setPosition(startPosition + (diff * progress));
             }
         }
+
+        void Move::compile(AnimationManager& manager)
+        {
+            if (targetNode)
+            {
+                manager.addMoveTrack(targetNode, startPosition, diff);
+            }
+        }
     } // namespace scene
 } // namespace ouzel
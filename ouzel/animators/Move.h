@@ -16,6 +16,7 @@ namespace ouzel
             Move(float aLength, const Vector3& aPosition, bool aRelative = false);
 
             virtual void start(Node* newTargetNode) override;
+            virtual void compile(AnimationManager& manager) override;
 
         protected:
             virtual void updateProgress() override;
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include "Parallel.h"
+#include "AnimationManager.h"
 
 namespace ouzel
 {
@@ -70,5 +71,15 @@ namespace ouzel
                 }
             }
         }
+
+        void Parallel::compile(AnimationManager& manager)
+        {
+            for (const auto& animator : animators)
+            {
+                manager.pushParallel(animator->getLength());
+                animator->compile(manager);
+                manager.popTimeMapping();
+            }
+        }
     } // namespace scene
 } // namespace ouzel
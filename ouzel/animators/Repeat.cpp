@@ -2,6 +2,7 @@
 // This file is part of the Ouzel engine.
 
 #include "Repeat.h"
+#include "AnimationManager.h"
 
 namespace ouzel
 {
@@ -75,5 +76,15 @@ namespace ouzel
                 }
             }
         }
+
+        void Repeat::compile(AnimationManager& manager)
+        {
+            if (animator)
+            {
+                manager.pushRepeat(animator->getLength(), count);
+                animator->compile(manager);
+                manager.popTimeMapping();
+            }
+        }
     } // namespace scene
 } // namespace ouzel
@@ -2,6 +2,7 @@
 // This file is part of the Ouzel engine.
 
 #include "Rotate.h"
+#include "AnimationManager.h"
 #include "scene/Node.h"
 
 namespace ouzel
@@ -36,5 +37,13 @@ namespace ouzel
                 targetNode->setRotation(startRotation + diff * progress);
             }
         }
+
+        void Rotate::compile(AnimationManager& manager)
+        {
+            if (targetNode)
+            {
+                manager.addRotateTrack(targetNode, startRotation, diff);
+            }
+        }
     } // namespace scene
 } // namespace ouzel
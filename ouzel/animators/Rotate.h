@@ -16,6 +16,7 @@ namespace ouzel
             Rotate(float aLength, const Vector3& aRotation, bool aRelative = false);
 
             virtual void start(Node* newTargetNode) override;
+            virtual void compile(AnimationManager& manager) override;
 
         protected:
             virtual void updateProgress() override;
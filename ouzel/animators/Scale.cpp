@@ -2,6 +2,7 @@
 // This file is part of the Ouzel engine.
 
 #include "Scale.h"
+#include "AnimationManager.h"
 #include "scene/Node.h"
 
 namespace ouzel
@@ -35,5 +36,13 @@ namespace ouzel
                 targetNode->setScale(startScale + (diff * progress));
             }
         }
+
+        void Scale::compile(AnimationManager& manager)
+        {
+            if (targetNode)
+            {
+                manager.addScaleTrack(targetNode, startScale, diff);
+            }
+        }
     } // namespace scene
 } // namespace ouzel
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <numeric>
 #include "Sequence.h"
+#include "AnimationManager.h"
 
 namespace ouzel
 {
@@ -70,5 +71,19 @@ namespace ouzel
                 time += animator->getLength();
             }
         }
+
+        void Sequence::compile(AnimationManager& manager)
+        {
+            float offset = 0.0f;
+
+            for (const auto& animator : animators)
+            {
+                manager.pushSequence(offset, animator->getLength());
+                animator->compile(manager);
+                manager.popTimeMapping();
+
+                offset += animator->getLength();
+            }
+        }
     } // namespace scene
 } // namespace ouzel
@@ -17,6 +17,7 @@ namespace ouzel
 
             virtual void start(Node* newTargetNode) override;
             virtual void reset() override;
+            virtual void compile(AnimationManager& manager) override;
 
         protected:
             virtual void removeAnimator(Animator* animator) override;
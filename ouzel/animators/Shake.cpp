@@ -14,9 +14,9 @@ namespace ouzel
         Shake::Shake(float aLength, const Vector3& aDistance, float aTimeScale):
             Animator(aLength), distance(aDistance), timeScale(aTimeScale)
         {
-            seedX = std::uniform_int_distribution<uint32_t>{0, std::numeric_limits<uint32_t>::max()}(randomEngine);
-            seedY = std::uniform_int_distribution<uint32_t>{0, std::numeric_limits<uint32_t>::max()}(randomEngine);
-            seedZ = std::uniform_int_distribution<uint32_t>{0, std::numeric_limits<uint32_t>::max()}(randomEngine);
+            seedX = randomEngine.getUInt32();
+            seedY = randomEngine.getUInt32();
+            seedZ = randomEngine.getUInt32();
         }
 
         void Shake::start(Node* newTargetNode)
@@ -5,6 +5,7 @@
 #include "core/Application.h"
 #include "files/FileSystem.h"
 #include "utils/Log.h"
+#include "utils/MemoryTracker.h"
 #include "utils/Utils.h"
 
 namespace ouzel
@@ -17,6 +18,7 @@ namespace ouzel
 
         SoundData::~SoundData()
         {
+            MemoryTracker::update(MemoryTracker::Tag::AUDIO, memorySize, 0);
         }
 
         bool SoundData::initFromFile(const std::string& newFilename)
@@ -142,6 +144,7 @@ namespace ouzel
                 else if (chunkHeader[0] == 'd' && chunkHeader[1] == 'a' && chunkHeader[2] == 't' && chunkHeader[3] == 'a')
                 {
                     data.assign(newData.begin() + static_cast<int>(offset), newData.begin() + static_cast<int>(offset + chunkSize));
+                    MemoryTracker::update(MemoryTracker::Tag::AUDIO, memorySize, data.capacity());
 
                     dataChunkFound = true;
                 }
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include "utils/Noncopyable.h"
 
 namespace ouzel
 {
@@ -13,7 +14,7 @@ namespace ouzel
     {
         class Audio;
 
-        class SoundData
+        class SoundData: public Noncopyable
         {
             friend Audio;
         public:
@@ -46,6 +47,7 @@ namespace ouzel
             uint16_t bitsPerSample = 0;
 
             std::vector<uint8_t> data;
+            size_t memorySize = 0;
 
             bool ready = false;
         };
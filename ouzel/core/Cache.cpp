@@ -13,6 +13,7 @@
 #include "scene/ParticleDefinition.h"
 #include "scene/SpriteFrame.h"
 #include "files/FileSystem.h"
+#include "utils/MemoryTracker.h"
 #include "utils/Utils.h"
 
 namespace ouzel
@@ -21,6 +22,12 @@ namespace ouzel
     {
     }
 
+    Cache::~Cache()
+    {
+        MemoryTracker::update(MemoryTracker::Tag::CACHE, memorySize, 0);
+        MemoryTracker::update(MemoryTracker::Tag::GUI, fontMemorySize, 0);
+    }
+
     void Cache::clear()
     {
         textures.clear();
@@ -29,6 +36,12 @@ namespace ouzel
         blendStates.clear();
         spriteFrames.clear();
         bmFonts.clear();
+        animationClips.clear();
+
+        spriteFrameMemorySize = 0;
+        particleDefinitionMemorySize = 0;
+        updateMemoryUsage();
+        MemoryTracker::update(MemoryTracker::Tag::GUI, fontMemorySize, 0);
     }
 
     void Cache::preloadTexture(const std::string& filename, bool dynamic, bool mipmaps)
@@ -150,7 +163,12 @@ namespace ouzel
             frames.push_back(frame);
         }
 
-        spriteFrames[filename] = frames;
+        std::vector<scene::SpriteFrame>& entry = spriteFrames[filename];
+        spriteFrameMemorySize -= entry.capacity() * sizeof(scene::SpriteFrame);
+        entry = frames;
+        spriteFrameMemorySize += entry.capacity() * sizeof(scene::SpriteFrame);
+
+        updateMemoryUsage();
     }
 
     const std::vector<scene::SpriteFrame>& Cache::getSpriteFrames(const std::string& filename, bool mipmaps) const
@@ -185,6 +203,8 @@ namespace ouzel
             }
 
             auto i = spriteFrames.insert(std::make_pair(filename, frames));
+            spriteFrameMemorySize += i.first->second.capacity() * sizeof(scene::SpriteFrame);
+            updateMemoryUsage();
 
             return i.first->second;
         }
@@ -192,12 +212,20 @@ namespace ouzel
 
     void Cache::setSpriteFrames(const std::string& filename, const std::vector<scene::SpriteFrame>& frames)
     {
-        spriteFrames[filename] = frames;
+        std::vector<scene::SpriteFrame>& entry = spriteFrames[filename];
+        spriteFrameMemorySize -= entry.capacity() * sizeof(scene::SpriteFrame);
+        entry = frames;
+        spriteFrameMemorySize += entry.capacity() * sizeof(scene::SpriteFrame);
+
+        updateMemoryUsage();
     }
 
     void Cache::releaseSpriteFrames()
     {
         spriteFrames.clear();
+
+        spriteFrameMemorySize = 0;
+        updateMemoryUsage();
     }
 
     void Cache::preloadParticleDefinition(const std::string& filename)
@@ -207,6 +235,9 @@ namespace ouzel
         if (i == particleDefinitions.end())
         {
             particleDefinitions[filename] = scene::ParticleDefinition::loadParticleDefinition(filename);
+
+            particleDefinitionMemorySize += sizeof(scene::ParticleDefinition);
+            updateMemoryUsage();
         }
     }
 
@@ -221,6 +252,8 @@ namespace ouzel
         else
         {
             auto i = particleDefinitions.insert(std::make_pair(filename, scene::ParticleDefinition::loadParticleDefinition(filename)));
+            particleDefinitionMemorySize += sizeof(scene::ParticleDefinition);
+            updateMemoryUsage();
 
             return i.first->second;
         }
@@ -229,6 +262,51 @@ namespace ouzel
     void Cache::releaseParticleDefinitions()
     {
         particleDefinitions.clear();
+
+        particleDefinitionMemorySize = 0;
+        updateMemoryUsage();
+    }
+
+    void Cache::preloadAnimationClip(const std::string& filename)
+    {
+        std::unordered_map<std::string, std::shared_ptr<scene::AnimationClip>>::const_iterator i = animationClips.find(filename);
+
+        if (i == animationClips.end())
+        {
+            std::shared_ptr<scene::AnimationClip> animationClip = std::make_shared<scene::AnimationClip>();
+            animationClip->initFromFile(filename);
+
+            animationClips[filename] = animationClip;
+        }
+    }
+
+    const std::shared_ptr<scene::AnimationClip>& Cache::getAnimationClip(const std::string& filename) const
+    {
+        std::unordered_map<std::string, std::shared_ptr<scene::AnimationClip>>::const_iterator i = animationClips.find(filename);
+
+        if (i != animationClips.end())
+        {
+            return i->second;
+        }
+        else
+        {
+            std::shared_ptr<scene::AnimationClip> result = std::make_shared<scene::AnimationClip>();
+            result->initFromFile(filename);
+
+            auto i = animationClips.insert(std::make_pair(filename, result));
+
+            return i.first->second;
+        }
+    }
+
+    void Cache::setAnimationClip(const std::string& filename, const std::shared_ptr<scene::AnimationClip>& animationClip)
+    {
+        animationClips[filename] = animationClip;
+    }
+
+    void Cache::releaseAnimationClips()
+    {
+        animationClips.clear();
     }
 
     void Cache::preloadBMFont(const std::string& filename)
@@ -237,7 +315,10 @@ namespace ouzel
 
         if (i == bmFonts.end())
         {
-            bmFonts[filename] = BMFont(filename);
+            BMFont& font = bmFonts[filename];
+            font = BMFont(filename);
+
+            MemoryTracker::update(MemoryTracker::Tag::GUI, fontMemorySize, fontMemorySize + font.getMemorySize());
         }
     }
 
@@ -252,6 +333,7 @@ namespace ouzel
         else
         {
             auto i = bmFonts.insert(std::make_pair(filename, BMFont(filename)));
+            MemoryTracker::update(MemoryTracker::Tag::GUI, fontMemorySize, fontMemorySize + i.first->second.getMemorySize());
 
             return i.first->second;
         }
@@ -260,5 +342,12 @@ namespace ouzel
     void Cache::releaseBMFonts()
     {
         bmFonts.clear();
+
+        MemoryTracker::update(MemoryTracker::Tag::GUI, fontMemorySize, 0);
+    }
+
+    void Cache::updateMemoryUsage() const
+    {
+        MemoryTracker::update(MemoryTracker::Tag::CACHE, memorySize, spriteFrameMemorySize + particleDefinitionMemorySize);
     }
 }
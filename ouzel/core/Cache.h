@@ -11,6 +11,7 @@
 #include "utils/Noncopyable.h"
 #include "scene/SpriteFrame.h"
 #include "scene/ParticleDefinition.h"
+#include "animators/AnimationClip.h"
 #include "gui/BMFont.h"
 #include "graphics/BlendState.h"
 #include "graphics/Shader.h"
@@ -22,6 +23,7 @@ namespace ouzel
     {
     public:
         Cache();
+        ~Cache();
 
         void clear();
 
@@ -47,6 +49,11 @@ namespace ouzel
         const scene::ParticleDefinition& getParticleDefinition(const std::string& filename) const;
         void releaseParticleDefinitions();
 
+        void preloadAnimationClip(const std::string& filename);
+        const std::shared_ptr<scene::AnimationClip>& getAnimationClip(const std::string& filename) const;
+        void setAnimationClip(const std::string& filename, const std::shared_ptr<scene::AnimationClip>& animationClip);
+        void releaseAnimationClips();
+
         void preloadBMFont(const std::string& filename);
         const BMFont& getBMFont(const std::string& filename) const;
         void releaseBMFonts();
@@ -58,5 +65,14 @@ namespace ouzel
         mutable std::unordered_map<std::string, std::shared_ptr<graphics::BlendState>> blendStates;
         mutable std::unordered_map<std::string, std::vector<scene::SpriteFrame>> spriteFrames;
         mutable std::unordered_map<std::string, BMFont> bmFonts;
+        mutable std::unordered_map<std::string, std::shared_ptr<scene::AnimationClip>> animationClips;
+
+        void updateMemoryUsage() const;
+
+        // only the cached data itself is counted, textures count their own memory and fonts are counted as GUI memory
+        mutable size_t spriteFrameMemorySize = 0;
+        mutable size_t particleDefinitionMemorySize = 0;
+        mutable size_t memorySize = 0;
+        mutable size_t fontMemorySize = 0;
     };
 }
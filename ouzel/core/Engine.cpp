@@ -2,10 +2,12 @@
 // This file is part of the Ouzel engine.
 
 #include <algorithm>
+#include <cmath>
 #include "Engine.h"
 #include "CompileConfig.h"
 #include "Window.h"
 #include "utils/Log.h"
+#include "utils/MemoryTracker.h"
 #include "graphics/Renderer.h"
 #include "audio/Audio.h"
 
@@ -93,10 +95,19 @@ namespace ouzel
     {
         running = false;
         active = false;
+        framePacer.wake();
 
 #if OUZEL_MULTITHREADED
         if (updateThread.joinable()) updateThread.join();
 #endif
+
+        // callbacks that outlive the engine must not unschedule themselves
+        while (scheduledUpdateCallbacks.first) scheduledUpdateCallbacks.erase(scheduledUpdateCallbacks.first);
+
+        for (const std::unique_ptr<UpdateCallbackList>& updateCallbackList : updateCallbackLists)
+        {
+            while (updateCallbackList->first) updateCallbackList->erase(updateCallbackList->first);
+        }
     }
 
     std::set<graphics::Renderer::Driver> Engine::getAvailableRenderDrivers()
@@ -349,6 +360,7 @@ namespace ouzel
     {
         running = false;
         active = false;
+        framePacer.wake();
     }
 
     void Engine::pause()
@@ -360,6 +372,7 @@ namespace ouzel
     {
         previousUpdateTime = std::chrono::steady_clock::now();
         running = true;
+        framePacer.wake();
     }
 
     void Engine::run()
@@ -383,60 +396,64 @@ namespace ouzel
         while (active)
         {
 #endif
+#if OUZEL_MULTITHREADED
+            // while paused the scene is only redrawn at the idle frame rate, so that the render thread is not blocked
+            framePacer.wait(!running);
+#endif
+
+            FrameAllocator::getThreadAllocator()->reset();
+
             if (running)
             {
                 std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
                 auto diff = currentTime - previousUpdateTime;
+                previousUpdateTime = currentTime;
 
-                if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
-                {
-                    previousUpdateTime = currentTime;
-                    float delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0f;
+                float delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0f;
 
-                    eventDispatcher.dispatchEvents();
+                MemoryTracker::updateAllocationRates(delta);
 
-                    if (sharedEngine->getRenderer()->getRefillDrawQueue())
-                    {
-                        sceneManager.draw();
-                        renderer->flushDrawCommands();
-                    }
+                eventDispatcher.dispatchEvents();
 
-                    // erase all null update callbacks from the list
-                    for (auto i = updateCallbacks.begin(); i != updateCallbacks.end();)
-                    {
-                        i = (*i) ? ++i : updateCallbacks.erase(i);
-                    }
+                if (sharedEngine->getRenderer()->getRefillDrawQueue())
+                {
+                    ++frameCount;
+                    sceneManager.draw();
+                    renderer->flushDrawCommands();
+                }
 
-                    if (!updateCallbackAddSet.empty())
+                if (fixedTimeStep > 0.0f)
+                {
+                    accumulatedTime += delta;
+
+                    for (uint32_t step = 0; accumulatedTime >= fixedTimeStep; ++step)
                     {
-                        for (const UpdateCallback* updateCallback : updateCallbackAddSet)
+                        if (step >= maxTimeSteps)
                         {
-                            auto i = std::find(updateCallbacks.begin(), updateCallbacks.end(), updateCallback);
-
-                            if (i == updateCallbacks.end())
-                            {
-                                updateCallbacks.push_back(updateCallback);
-                            }
+                            // too far behind, the rest of the time is dropped, so that slow steps do not pile up
+                            accumulatedTime = fmodf(accumulatedTime, fixedTimeStep);
+                            break;
                         }
 
-                        std::stable_sort(updateCallbacks.begin(), updateCallbacks.end(), [](const UpdateCallback* a, const UpdateCallback* b) {
-                            return a->priority > b->priority;
-                        });
+                        ++timeStepCount;
+                        update(fixedTimeStep);
+                        accumulatedTime -= fixedTimeStep;
                     }
 
-                    for (const UpdateCallback* updateCallback : updateCallbacks)
-                    {
-                        if (updateCallback && updateCallback->callback)
-                        {
-                            updateCallback->callback(delta);
-                        }
-                    }
+                    interpolationAlpha = accumulatedTime / fixedTimeStep;
                 }
                 else
                 {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    update(delta);
                 }
             }
+            else if (sharedEngine->getRenderer()->getRefillDrawQueue())
+            {
+                // the cached draw transforms of the nodes are keyed by the frame count
+                ++frameCount;
+                sceneManager.draw();
+                renderer->flushDrawCommands();
+            }
 #if OUZEL_MULTITHREADED
         }
 
@@ -450,12 +467,57 @@ namespace ouzel
 #endif
     }
 
+    void Engine::update(float delta)
+    {
+        while (UpdateCallback* updateCallback = scheduledUpdateCallbacks.first)
+        {
+            scheduledUpdateCallbacks.erase(updateCallback);
+            getUpdateCallbackList(updateCallback->priority)->pushBack(updateCallback);
+        }
+
+        // lists are only added above, so the vector does not change while the callbacks are called
+        for (const std::unique_ptr<UpdateCallbackList>& updateCallbackList : updateCallbackLists)
+        {
+            for (UpdateCallback* updateCallback = updateCallbackList->first; updateCallback; updateCallback = nextUpdateCallback)
+            {
+                // unscheduleUpdate moves this forward if it removes the next callback
+                nextUpdateCallback = updateCallback->next;
+
+                if (updateCallback->callback)
+                {
+                    updateCallback->callback(delta);
+                }
+            }
+        }
+
+        nextUpdateCallback = nullptr;
+    }
+
+    UpdateCallbackList* Engine::getUpdateCallbackList(int32_t priority)
+    {
+        auto i = std::lower_bound(updateCallbackLists.begin(), updateCallbackLists.end(), priority,
+                                  [](const std::unique_ptr<UpdateCallbackList>& updateCallbackList, int32_t value) {
+            return updateCallbackList->priority > value;
+        });
+
+        if (i == updateCallbackLists.end() || (*i)->priority != priority)
+        {
+            i = updateCallbackLists.insert(i, std::unique_ptr<UpdateCallbackList>(new UpdateCallbackList(priority)));
+        }
+
+        return i->get();
+    }
+
     bool Engine::draw()
     {
-#if !OUZEL_MULTITHREADED
+#if OUZEL_MULTITHREADED
+        FrameAllocator::getThreadAllocator()->reset();
+#else
         Engine::run();
 #endif
 
+        jobSystem.runMainThreadJobs();
+
         if (!renderer->process())
         {
             return false;
@@ -464,32 +526,36 @@ namespace ouzel
         return active;
     }
 
-    void Engine::scheduleUpdate(const UpdateCallback* callback)
+    void Engine::scheduleUpdate(UpdateCallback* callback)
     {
-        updateCallbackAddSet.insert(callback);
+        if (!callback->list)
+        {
+            scheduledUpdateCallbacks.pushBack(callback);
+        }
     }
 
-    void Engine::unscheduleUpdate(const UpdateCallback* callback)
+    void Engine::unscheduleUpdate(UpdateCallback* callback)
     {
-        auto vectorIterator = std::find(updateCallbacks.begin(), updateCallbacks.end(), callback);
-
-        if (vectorIterator != updateCallbacks.end())
+        if (callback->list)
         {
-            *vectorIterator = nullptr;
-        }
+            if (callback == nextUpdateCallback) nextUpdateCallback = callback->next;
 
-        auto setIterator = updateCallbackAddSet.find(callback);
-
-        if (setIterator != updateCallbackAddSet.end())
-        {
-            updateCallbackAddSet.erase(setIterator);
+            callback->list->erase(callback);
         }
     }
 
+    void Engine::setFixedTimeStep(float newFixedTimeStep)
+    {
+        fixedTimeStep = newFixedTimeStep;
+        accumulatedTime = 0.0f;
+        interpolationAlpha = 1.0f;
+    }
+
     void Engine::exitUpdateThread()
     {
         running = false;
         active = false;
+        framePacer.wake();
 
 #if OUZEL_MULTITHREADED
         if (updateThread.joinable()) updateThread.join();
@@ -13,10 +13,16 @@
 #include "CompileConfig.h"
 #include "utils/Types.h"
 #include "utils/Noncopyable.h"
+#include "utils/ObjectPool.h"
 #include "core/UpdateCallback.h"
+#include "core/FrameAllocator.h"
+#include "core/JobSystem.h"
+#include "core/FramePacer.h"
 #include "core/Settings.h"
 #include "events/EventDispatcher.h"
 #include "scene/SceneManager.h"
+#include "animators/AnimationManager.h"
+#include "scene/ParticleManager.h"
 #include "core/Cache.h"
 #include "localization/Localization.h"
 
@@ -42,10 +48,16 @@ namespace ouzel
 
         EventDispatcher* getEventDispatcher() { return &eventDispatcher; }
         Cache* getCache() { return &cache; }
+        JobSystem* getJobSystem() { return &jobSystem; }
+        FramePacer* getFramePacer() { return &framePacer; }
+        // frame allocator of the calling thread, its memory must not be used after the end of the frame (or job)
+        FrameAllocator* getFrameAllocator() const { return FrameAllocator::getThreadAllocator(); }
         Window* getWindow() const { return window.get(); }
         graphics::Renderer* getRenderer() const { return renderer.get(); }
         audio::Audio* getAudio() const { return audio.get(); }
         scene::SceneManager* getSceneManager() { return &sceneManager; }
+        scene::ParticleManager* getParticleManager() { return &particleManager; }
+        scene::AnimationManager* getAnimationManager() { return &animationManager; }
         input::Input* getInput() const { return input.get(); }
         Localization* getLocalization() { return &localization; }
 
@@ -56,16 +68,70 @@ namespace ouzel
         bool isRunning() const { return running; }
         bool isActive() const { return active; }
 
-        void scheduleUpdate(const UpdateCallback* callback);
-        void unscheduleUpdate(const UpdateCallback* callback);
+        // both are O(1) and can be called from update callbacks, a scheduled callback is first called the next frame
+        void scheduleUpdate(UpdateCallback* callback);
+        void unscheduleUpdate(UpdateCallback* callback);
+
+        // 0 (the default) calls the update callbacks once per frame with the elapsed time, otherwise they are called
+        // with the fixed delta as many times as needed to catch up, but at most maxTimeSteps times per frame
+        void setFixedTimeStep(float newFixedTimeStep);
+        float getFixedTimeStep() const { return fixedTimeStep; }
+        void setMaxTimeSteps(uint32_t newMaxTimeSteps) { maxTimeSteps = newMaxTimeSteps; }
+        uint32_t getMaxTimeSteps() const { return maxTimeSteps; }
+        uint32_t getTimeStepCount() const { return timeStepCount; }
+
+        // with a fixed time step, node transforms are drawn blended between the last two steps
+        void setTransformInterpolation(bool newTransformInterpolation) { transformInterpolation = newTransformInterpolation; }
+        bool getTransformInterpolation() const { return transformInterpolation; }
+        bool isInterpolatingTransforms() const { return transformInterpolation && fixedTimeStep > 0.0f; }
+        // position between the last two steps at which the scene is drawn, from 0 (previous step) to 1 (last step)
+        float getInterpolationAlpha() const { return interpolationAlpha; }
+        uint32_t getFrameCount() const { return frameCount; }
 
         void exitUpdateThread();
 
+        // the object is returned to the pool of T when the handle is destroyed, also after it is converted to a handle
+        // of a base class (for example PoolPtr<scene::Node>)
+        template<class T, class... Args>
+        PoolPtr<T> create(Args&&... args)
+        {
+            ObjectPool<T>* pool = getObjectPool<T>();
+            T* object = pool->create(std::forward<Args>(args)...);
+
+            return PoolPtr<T>(object, PoolDeleter(pool, object));
+        }
+
+        template<class T>
+        ObjectPool<T>* getObjectPool()
+        {
+            static const uint32_t typeId = ObjectPoolBase::getNextTypeId();
+
+            if (typeId >= objectPools.size())
+            {
+                objectPools.resize(typeId + 1);
+            }
+
+            if (!objectPools[typeId])
+            {
+                objectPools[typeId].reset(new ObjectPool<T>());
+            }
+
+            return static_cast<ObjectPool<T>*>(objectPools[typeId].get());
+        }
+
+        const std::vector<std::unique_ptr<ObjectPoolBase>>& getObjectPools() const { return objectPools; }
+
     protected:
         void run();
+        void update(float delta);
 
         Settings settings;
 
+        std::vector<std::unique_ptr<ObjectPoolBase>> objectPools;
+
+        // declared before all the subsystems that submit jobs, so that it is destroyed after them
+        JobSystem jobSystem;
+
         std::unique_ptr<Window> window;
         std::unique_ptr<graphics::Renderer> renderer;
         std::unique_ptr<audio::Audio> audio;
@@ -73,12 +139,26 @@ namespace ouzel
         EventDispatcher eventDispatcher;
         Localization localization;
         Cache cache;
+        scene::AnimationManager animationManager;
+        scene::ParticleManager particleManager;
         scene::SceneManager sceneManager;
 
+        FramePacer framePacer;
         std::chrono::steady_clock::time_point previousUpdateTime;
 
-        std::vector<const UpdateCallback*> updateCallbacks;
-        std::set<const UpdateCallback*> updateCallbackAddSet;
+        float fixedTimeStep = 0.0f;
+        uint32_t maxTimeSteps = 5;
+        float accumulatedTime = 0.0f;
+        uint32_t timeStepCount = 0;
+        bool transformInterpolation = true;
+        float interpolationAlpha = 1.0f;
+        uint32_t frameCount = 0;
+
+        UpdateCallbackList* getUpdateCallbackList(int32_t priority);
+
+        UpdateCallbackList scheduledUpdateCallbacks; // not called before the next update
+        std::vector<std::unique_ptr<UpdateCallbackList>> updateCallbackLists; // sorted by descending priority
+        UpdateCallback* nextUpdateCallback = nullptr;
 
 #if OUZEL_MULTITHREADED
         std::thread updateThread;
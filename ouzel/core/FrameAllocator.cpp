@@ -0,0 +1,77 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "FrameAllocator.h"
+
+namespace ouzel
+{
+    FrameAllocator::FrameAllocator(size_t aBlockSize):
+        blockSize(aBlockSize)
+    {
+    }
+
+    void* FrameAllocator::allocate(size_t size, size_t alignment)
+    {
+        uintptr_t address = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~(alignment - 1);
+
+        if (!current || address + size > reinterpret_cast<uintptr_t>(end))
+        {
+            usedSize += static_cast<size_t>(current - blockStart);
+            addBlock(std::max(blockSize, size + alignment));
+
+            address = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~(alignment - 1);
+        }
+
+        current = reinterpret_cast<uint8_t*>(address + size);
+
+        size_t used = getUsedSize();
+        if (used > peakSize) peakSize = used;
+
+        return reinterpret_cast<void*>(address);
+    }
+
+    void FrameAllocator::reset()
+    {
+        if (blocks.size() > 1)
+        {
+            // the next frame will most likely need as much memory, so it gets one block that fits all of it
+            size_t capacity = getCapacity();
+            blocks.clear();
+            addBlock(capacity);
+        }
+        else if (!blocks.empty())
+        {
+            current = blockStart;
+        }
+
+        usedSize = 0;
+    }
+
+    size_t FrameAllocator::getCapacity() const
+    {
+        size_t capacity = 0;
+
+        for (const auto& block : blocks)
+        {
+            capacity += block.second;
+        }
+
+        return capacity;
+    }
+
+    FrameAllocator* FrameAllocator::getThreadAllocator()
+    {
+        static thread_local FrameAllocator frameAllocator;
+        return &frameAllocator;
+    }
+
+    void FrameAllocator::addBlock(size_t size)
+    {
+        blocks.push_back(std::make_pair(std::unique_ptr<uint8_t[]>(new uint8_t[size]), size));
+        ++heapAllocationCount;
+
+        blockStart = current = blocks.back().first.get();
+        end = blockStart + size;
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    // Linear allocator for data that is only needed until the end of the frame. Every thread has its own one, the update
+    // thread resets it at the start of every frame, the main thread in Engine::draw and the job workers after every job.
+    // An allocation moves a pointer forward and deallocation does nothing. If a block is full, another one is allocated
+    // from the heap, on reset they are replaced by one block that is big enough for the whole frame.
+    class FrameAllocator: public Noncopyable
+    {
+    public:
+        FrameAllocator(size_t aBlockSize = 64 * 1024);
+
+        void* allocate(size_t size, size_t alignment);
+        void reset();
+
+        // sizes in bytes
+        size_t getUsedSize() const { return usedSize + static_cast<size_t>(current - blockStart); }
+        size_t getPeakSize() const { return peakSize; }
+        size_t getCapacity() const;
+        // number of blocks allocated from the heap since the allocator was created
+        uint32_t getHeapAllocationCount() const { return heapAllocationCount; }
+
+        static FrameAllocator* getThreadAllocator();
+
+    protected:
+        void addBlock(size_t size);
+
+        size_t blockSize;
+        std::vector<std::pair<std::unique_ptr<uint8_t[]>, size_t>> blocks;
+        uint8_t* blockStart = nullptr;
+        uint8_t* current = nullptr;
+        uint8_t* end = nullptr;
+
+        size_t usedSize = 0; // in the full blocks
+        size_t peakSize = 0;
+        uint32_t heapAllocationCount = 0;
+    };
+
+    // STL allocator that takes memory from a frame allocator, without one it uses the heap,
+    // so the same container type can be kept between frames
+    template<class T>
+    class FrameStlAllocator
+    {
+        template<class U> friend class FrameStlAllocator;
+    public:
+        typedef T value_type;
+
+        FrameStlAllocator(FrameAllocator* aFrameAllocator = nullptr) noexcept: frameAllocator(aFrameAllocator) { }
+        template<class U> FrameStlAllocator(const FrameStlAllocator<U>& other) noexcept: frameAllocator(other.frameAllocator) { }
+
+        T* allocate(size_t count)
+        {
+            if (frameAllocator)
+            {
+                return static_cast<T*>(frameAllocator->allocate(count * sizeof(T), alignof(T)));
+            }
+
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        }
+
+        void deallocate(T* pointer, size_t) noexcept
+        {
+            if (!frameAllocator)
+            {
+                ::operator delete(pointer);
+            }
+        }
+
+        FrameAllocator* getFrameAllocator() const { return frameAllocator; }
+
+        template<class U> bool operator==(const FrameStlAllocator<U>& other) const { return frameAllocator == other.frameAllocator; }
+        template<class U> bool operator!=(const FrameStlAllocator<U>& other) const { return frameAllocator != other.frameAllocator; }
+
+    private:
+        FrameAllocator* frameAllocator;
+    };
+
+    template<class T> using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+}
@@ -0,0 +1,172 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "FramePacer.h"
+#include "core/CompileConfig.h"
+#include "math/MathUtils.h"
+
+#if OUZEL_PLATFORM_LINUX || OUZEL_PLATFORM_ANDROID || OUZEL_PLATFORM_RASPBIAN
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace ouzel
+{
+    // the longest time spun, the rest is always slept
+    static const float MAX_SPIN_TIME = 0.002f;
+    // shorter frames (like the default 1 ms) are only slept, spinning would keep a core busy for little gain in precision
+    static const float MIN_SPIN_FRAME_TIME = 0.004f;
+
+    FramePacer::FramePacer():
+        idle(false), woken(false), sleeping(false)
+    {
+        frameStart = nextFrame = std::chrono::steady_clock::now();
+    }
+
+    void FramePacer::setIdle(bool newIdle)
+    {
+        idle = newIdle;
+
+        if (!newIdle) wake();
+    }
+
+    void FramePacer::wait(bool forceIdle)
+    {
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+
+        if (forceIdle || idle)
+        {
+            auto timeout = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(idleFrameTime));
+
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            sleeping = true;
+
+            // an event posted before this point has set woken, so it is not missed
+            while (!woken)
+            {
+                if (wakeCondition.wait_until(lock, currentTime + timeout) == std::cv_status::timeout) break;
+            }
+
+            sleeping = false;
+            woken = false;
+
+            frameStart = nextFrame = std::chrono::steady_clock::now();
+            previousFrameIdle = true;
+
+            return;
+        }
+
+        woken = false;
+
+        if (targetFrameTime > 0.0f)
+        {
+            auto frameTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(targetFrameTime));
+
+            nextFrame += frameTime;
+
+            // more than a frame late, start over instead of trying to catch up
+            if (nextFrame + frameTime < currentTime) nextFrame = currentTime;
+
+            if (targetFrameTime < MIN_SPIN_FRAME_TIME) spinTime = 0.0f;
+
+            auto spin = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(spinTime));
+            std::chrono::steady_clock::time_point wakeTime = nextFrame - spin;
+
+            if (wakeTime > currentTime)
+            {
+                sleepUntil(wakeTime);
+
+                float overshoot = std::chrono::duration<float>(std::chrono::steady_clock::now() - wakeTime).count();
+                overshoot = std::max(overshoot, 0.0f);
+
+                // spin long enough to cover nearly all wake-ups of this system
+                float difference = overshoot - overshootMean;
+                overshootMean += 0.1f * difference;
+                overshootVariance = 0.9f * (overshootVariance + 0.1f * difference * difference);
+
+                if (targetFrameTime >= MIN_SPIN_FRAME_TIME)
+                {
+                    spinTime = clamp(overshootMean + 3.0f * sqrtf(overshootVariance), 0.0f, std::min(MAX_SPIN_TIME, targetFrameTime / 4.0f));
+                }
+            }
+
+            // without spinning the late wake-up is accepted
+            if (targetFrameTime >= MIN_SPIN_FRAME_TIME)
+            {
+                while (std::chrono::steady_clock::now() < nextFrame)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        currentTime = std::chrono::steady_clock::now();
+
+        if (!previousFrameIdle)
+        {
+            addFrameTime(std::chrono::duration<float>(currentTime - frameStart).count());
+        }
+
+        frameStart = currentTime;
+        if (targetFrameTime <= 0.0f) nextFrame = currentTime;
+        previousFrameIdle = false;
+    }
+
+    void FramePacer::wake()
+    {
+        woken = true;
+
+        if (sleeping)
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.notify_all();
+        }
+    }
+
+    void FramePacer::resetStatistics()
+    {
+        frameCount = 0;
+        frameTimeMean = 0.0;
+        frameTimeM2 = 0.0;
+        minFrameTime = 0.0f;
+        maxFrameTime = 0.0f;
+    }
+
+    void FramePacer::sleepUntil(std::chrono::steady_clock::time_point time)
+    {
+#if OUZEL_PLATFORM_LINUX || OUZEL_PLATFORM_ANDROID || OUZEL_PLATFORM_RASPBIAN
+        // steady_clock is CLOCK_MONOTONIC here, sleeping until an absolute time does not add the error of computing the interval
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+
+        timespec timeSpec;
+        timeSpec.tv_sec = static_cast<time_t>(nanoseconds / 1000000000);
+        timeSpec.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &timeSpec, nullptr) == EINTR);
+#else
+        std::this_thread::sleep_until(time);
+#endif
+    }
+
+    void FramePacer::addFrameTime(float frameTime)
+    {
+        ++frameCount;
+
+        double difference = frameTime - frameTimeMean;
+        frameTimeMean += difference / frameCount;
+        frameTimeM2 += difference * (frameTime - frameTimeMean);
+
+        if (frameCount == 1)
+        {
+            minFrameTime = maxFrameTime = frameTime;
+        }
+        else
+        {
+            minFrameTime = std::min(minFrameTime, frameTime);
+            maxFrameTime = std::max(maxFrameTime, frameTime);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    class Engine;
+
+    // Paces the update thread. Most of the wait is slept and the last part is spun, the spin time adapts to how much
+    // the sleeps of this system overshoot. In idle mode the thread blocks until an event is posted or the idle
+    // frame time passes, so static scenes do not use CPU.
+    class FramePacer: public Noncopyable
+    {
+        friend Engine;
+    public:
+        // 0 means no limit, target frame times below 4 ms are only slept, without spinning
+        void setTargetFrameTime(float newTargetFrameTime) { targetFrameTime = newTargetFrameTime; }
+        float getTargetFrameTime() const { return targetFrameTime; }
+
+        void setIdleFrameTime(float newIdleFrameTime) { idleFrameTime = newIdleFrameTime; }
+        float getIdleFrameTime() const { return idleFrameTime; }
+
+        // should be set while nothing on the screen changes without input
+        void setIdle(bool newIdle);
+        bool isIdle() const { return idle; }
+
+        // blocks until the next frame is due
+        void wait(bool forceIdle = false);
+        // ends an idle wait, can be called from any thread
+        void wake();
+
+        // statistics of the frame times since the last reset (idle frames are not counted), in seconds
+        uint32_t getFrameCount() const { return frameCount; }
+        float getAverageFrameTime() const { return static_cast<float>(frameTimeMean); }
+        float getFrameTimeVariance() const { return frameCount > 1 ? static_cast<float>(frameTimeM2 / (frameCount - 1)) : 0.0f; }
+        float getMinFrameTime() const { return minFrameTime; }
+        float getMaxFrameTime() const { return maxFrameTime; }
+        void resetStatistics();
+
+        // time spun at the end of every wait to make up for late wake-ups
+        float getSpinTime() const { return spinTime; }
+
+    protected:
+        FramePacer();
+
+        void sleepUntil(std::chrono::steady_clock::time_point time);
+        void addFrameTime(float frameTime);
+
+        float targetFrameTime = 0.001f;
+        float idleFrameTime = 0.1f;
+        std::atomic<bool> idle;
+
+        std::chrono::steady_clock::time_point frameStart;
+        std::chrono::steady_clock::time_point nextFrame;
+        bool previousFrameIdle = true;
+
+        float spinTime = 0.0f;
+        float overshootMean = 0.0f;
+        float overshootVariance = 0.0f;
+
+        uint32_t frameCount = 0;
+        double frameTimeMean = 0.0;
+        double frameTimeM2 = 0.0;
+        float minFrameTime = 0.0f;
+        float maxFrameTime = 0.0f;
+
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        std::atomic<bool> woken;
+        std::atomic<bool> sleeping;
+    };
+}
@@ -0,0 +1,379 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "JobSystem.h"
+#include "FrameAllocator.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    JobSystem::JobSystem():
+        queuedJobs(0), stealStart(0)
+#if OUZEL_MULTITHREADED
+        , sleepingWorkers(0)
+#endif
+    {
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+
+#if OUZEL_MULTITHREADED
+        mainThreadId = std::this_thread::get_id();
+
+        uint32_t cpuCount = std::thread::hardware_concurrency();
+        startWorkers((cpuCount > 1) ? cpuCount - 1 : 0);
+#endif
+    }
+
+    JobSystem::~JobSystem()
+    {
+#if OUZEL_MULTITHREADED
+        stopWorkers();
+#endif
+    }
+
+    void JobSystem::setWorkerCount(uint32_t newWorkerCount)
+    {
+#if OUZEL_MULTITHREADED
+        stopWorkers();
+        startWorkers(newWorkerCount);
+
+        // without workers jobs are run when they are submitted, so the queued ones are run now
+        if (!newWorkerCount)
+        {
+            while (runJob(0));
+        }
+#else
+        OUZEL_UNUSED(newWorkerCount);
+#endif
+    }
+
+    uint32_t JobSystem::getWorkerCount() const
+    {
+#if OUZEL_MULTITHREADED
+        return static_cast<uint32_t>(workers.size());
+#else
+        return 0;
+#endif
+    }
+
+    void JobSystem::run(const std::function<void()>& function,
+                        Counter* counter,
+                        Counter* dependency,
+                        Affinity affinity)
+    {
+        if (counter) ++counter->value;
+
+        Job job;
+        job.function = function;
+        job.counter = counter;
+        job.affinity = affinity;
+
+        if (dependency)
+        {
+            std::unique_lock<std::mutex> lock(dependency->dependantMutex);
+
+            if (dependency->value)
+            {
+                dependency->dependants.push_back(std::move(job));
+                return;
+            }
+        }
+
+        submit(std::move(job));
+    }
+
+    void JobSystem::wait(Counter& counter)
+    {
+        uint32_t queueIndex = getQueueIndex();
+        bool mainThread = isMainThread();
+
+        while (counter.value)
+        {
+            if (mainThread && runMainThreadJob()) continue;
+            if (runJob(queueIndex)) continue;
+
+#if OUZEL_MULTITHREADED
+            std::this_thread::yield();
+#else
+            // without workers every job has already run, except the ones that wait for a counter
+            break;
+#endif
+        }
+
+        // the thread that finished the last job can still hold the lock
+        std::unique_lock<std::mutex> lock(counter.dependantMutex);
+    }
+
+    void JobSystem::parallelFor(uint32_t count, const std::function<void(uint32_t)>& function, uint32_t batchSize)
+    {
+        if (!batchSize) batchSize = 1;
+
+        if (count <= batchSize || !getWorkerCount())
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                function(i);
+            }
+
+            return;
+        }
+
+        Counter counter;
+
+        for (uint32_t begin = 0; begin < count; begin += batchSize)
+        {
+            uint32_t end = std::min(begin + batchSize, count);
+
+            run([&function, begin, end]() {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    function(i);
+                }
+            }, &counter);
+        }
+
+        // the calling thread works too
+        wait(counter);
+    }
+
+    void JobSystem::runMainThreadJobs()
+    {
+        size_t jobCount;
+
+        {
+            std::unique_lock<std::mutex> lock(mainThreadMutex);
+            jobCount = mainThreadJobs.size();
+        }
+
+        // jobs submitted by these jobs are run next frame
+        for (size_t i = 0; i < jobCount; ++i)
+        {
+            if (!runMainThreadJob()) break;
+        }
+    }
+
+    bool JobSystem::isMainThread() const
+    {
+#if OUZEL_MULTITHREADED
+        return std::this_thread::get_id() == mainThreadId;
+#else
+        return true;
+#endif
+    }
+
+    void JobSystem::submit(Job&& job)
+    {
+        if (job.affinity == Affinity::MAIN_THREAD)
+        {
+            std::unique_lock<std::mutex> lock(mainThreadMutex);
+            mainThreadJobs.push_back(std::move(job));
+            return;
+        }
+
+#if OUZEL_MULTITHREADED
+        if (!workers.empty())
+        {
+            Queue& queue = *queues[getQueueIndex()];
+
+            ++queuedJobs;
+
+            {
+                std::unique_lock<std::mutex> lock(queue.mutex);
+                queue.jobs.push_back(std::move(job));
+            }
+
+            if (sleepingWorkers)
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeCondition.notify_one();
+            }
+
+            return;
+        }
+#endif
+
+        execute(job);
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        job.function();
+
+        if (Counter* counter = job.counter)
+        {
+            std::vector<Job> released;
+
+            {
+                std::unique_lock<std::mutex> lock(counter->dependantMutex);
+
+                if (--counter->value == 0)
+                {
+                    released.swap(counter->dependants);
+                }
+            }
+
+            for (Job& dependant : released)
+            {
+                submit(std::move(dependant));
+            }
+        }
+    }
+
+    bool JobSystem::runJob(uint32_t queueIndex)
+    {
+        if (!queuedJobs) return false;
+
+        Job job;
+        bool found = false;
+
+        {
+            Queue& queue = *queues[queueIndex];
+            std::unique_lock<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            // steal the oldest job of another queue, threads start from different queues to spread the contention
+            uint32_t queueCount = static_cast<uint32_t>(queues.size());
+            uint32_t start = stealStart++;
+
+            for (uint32_t i = 0; i < queueCount && !found; ++i)
+            {
+                uint32_t index = (start + i) % queueCount;
+                if (index == queueIndex) continue;
+
+                Queue& queue = *queues[index];
+                std::unique_lock<std::mutex> lock(queue.mutex);
+
+                if (!queue.jobs.empty())
+                {
+                    job = std::move(queue.jobs.front());
+                    queue.jobs.pop_front();
+                    found = true;
+                }
+            }
+        }
+
+        if (!found) return false;
+
+        --queuedJobs;
+        execute(job);
+
+        return true;
+    }
+
+    bool JobSystem::runMainThreadJob()
+    {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(mainThreadMutex);
+            if (mainThreadJobs.empty()) return false;
+
+            job = std::move(mainThreadJobs.front());
+            mainThreadJobs.pop_front();
+        }
+
+        execute(job);
+
+        return true;
+    }
+
+    uint32_t JobSystem::getQueueIndex() const
+    {
+#if OUZEL_MULTITHREADED
+        std::thread::id threadId = std::this_thread::get_id();
+
+        for (uint32_t i = 0; i < workerIds.size(); ++i)
+        {
+            if (workerIds[i] == threadId) return i + 1;
+        }
+#endif
+
+        return 0;
+    }
+
+#if OUZEL_MULTITHREADED
+    void JobSystem::startWorkers(uint32_t workerCount)
+    {
+        // workers wait for the lock before running any jobs, so all the ids are known by then
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        exiting = false;
+
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            queues.push_back(std::unique_ptr<Queue>(new Queue()));
+        }
+
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            workers.push_back(std::thread(&JobSystem::workerMain, this, i + 1));
+            workerIds.push_back(workers.back().get_id());
+        }
+    }
+
+    void JobSystem::stopWorkers()
+    {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            exiting = true;
+        }
+
+        wakeCondition.notify_all();
+
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+
+        workers.clear();
+        workerIds.clear();
+
+        // jobs left in the queues of the workers are moved to the shared queue
+        for (size_t i = 1; i < queues.size(); ++i)
+        {
+            for (Job& job : queues[i]->jobs)
+            {
+                queues[0]->jobs.push_back(std::move(job));
+            }
+        }
+
+        queues.resize(1);
+    }
+
+    void JobSystem::workerMain(uint32_t queueIndex)
+    {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+        }
+
+        FrameAllocator* frameAllocator = FrameAllocator::getThreadAllocator();
+
+        for (;;)
+        {
+            if (runJob(queueIndex))
+            {
+                // memory of the frame allocator only lives as long as the job on worker threads
+                frameAllocator->reset();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wakeMutex);
+
+            // a job that is submitted after the check sees the sleeping worker and wakes it up
+            ++sleepingWorkers;
+            while (!exiting && !queuedJobs) wakeCondition.wait(lock);
+            --sleepingWorkers;
+
+            if (exiting) break;
+        }
+    }
+#endif
+}
@@ -0,0 +1,125 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "core/CompileConfig.h"
+#if OUZEL_MULTITHREADED
+#include <condition_variable>
+#include <thread>
+#endif
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    class Engine;
+
+    // Work-stealing job scheduler shared by all engine subsystems.
+    // Every worker has its own deque, it takes jobs from the back and, when it runs out of them, steals from the front of
+    // the other deques. Jobs submitted from threads that are not workers (the update thread, loaders) go to a shared deque.
+    // Jobs with MAIN_THREAD affinity are run by the thread that calls Engine::draw (the one that owns the graphics context).
+    class JobSystem: public Noncopyable
+    {
+        friend Engine;
+    public:
+        enum class Affinity
+        {
+            ANY,
+            MAIN_THREAD
+        };
+
+        class Counter;
+
+    protected:
+        struct Job
+        {
+            std::function<void()> function;
+            Counter* counter;
+            Affinity affinity;
+        };
+
+    public:
+        // number of unfinished jobs, jobs can wait for a counter to reach zero before they are started
+        class Counter: public Noncopyable
+        {
+            friend JobSystem;
+        public:
+            Counter(): value(0) {}
+
+            uint32_t getValue() const { return value; }
+            bool isDone() const { return value == 0; }
+
+        protected:
+            std::atomic<uint32_t> value;
+            std::mutex dependantMutex;
+            std::vector<Job> dependants;
+        };
+
+        virtual ~JobSystem();
+
+        // changes the number of worker threads, must not be called while jobs are running
+        void setWorkerCount(uint32_t newWorkerCount);
+        uint32_t getWorkerCount() const;
+
+        // the counter (if any) is incremented now and decremented when the job finishes,
+        // the job is not started before the dependency counter (if any) reaches zero
+        void run(const std::function<void()>& function,
+                 Counter* counter = nullptr,
+                 Counter* dependency = nullptr,
+                 Affinity affinity = Affinity::ANY);
+
+        // runs other jobs until the counter reaches zero, a counter must not be destroyed before waiting for it
+        void wait(Counter& counter);
+
+        // calls the function for every index from 0 to count - 1, batchSize indices per job, returns when all are done
+        void parallelFor(uint32_t count, const std::function<void(uint32_t)>& function, uint32_t batchSize = 1);
+
+        // called by the main thread once per frame
+        void runMainThreadJobs();
+
+        bool isMainThread() const;
+
+    protected:
+        JobSystem();
+
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        void submit(Job&& job);
+        void execute(Job& job);
+        bool runJob(uint32_t queueIndex);
+        bool runMainThreadJob();
+        uint32_t getQueueIndex() const;
+
+        std::vector<std::unique_ptr<Queue>> queues; // queue 0 is shared by all threads that are not workers
+        std::atomic<uint32_t> queuedJobs;
+        std::atomic<uint32_t> stealStart;
+
+        std::mutex mainThreadMutex;
+        std::deque<Job> mainThreadJobs;
+
+#if OUZEL_MULTITHREADED
+        void startWorkers(uint32_t workerCount);
+        void stopWorkers();
+        void workerMain(uint32_t queueIndex);
+
+        std::thread::id mainThreadId;
+        std::vector<std::thread> workers;
+        std::vector<std::thread::id> workerIds;
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        std::atomic<uint32_t> sleepingWorkers;
+        bool exiting = false;
+#endif
+    };
+}
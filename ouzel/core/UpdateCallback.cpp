@@ -6,8 +6,72 @@
 
 namespace ouzel
 {
+    void UpdateCallbackList::pushBack(UpdateCallback* updateCallback)
+    {
+        updateCallback->list = this;
+        updateCallback->previous = last;
+        updateCallback->next = nullptr;
+
+        if (last)
+        {
+            last->next = updateCallback;
+        }
+        else
+        {
+            first = updateCallback;
+        }
+
+        last = updateCallback;
+    }
+
+    void UpdateCallbackList::erase(UpdateCallback* updateCallback)
+    {
+        if (updateCallback->previous)
+        {
+            updateCallback->previous->next = updateCallback->next;
+        }
+        else
+        {
+            first = updateCallback->next;
+        }
+
+        if (updateCallback->next)
+        {
+            updateCallback->next->previous = updateCallback->previous;
+        }
+        else
+        {
+            last = updateCallback->previous;
+        }
+
+        updateCallback->list = nullptr;
+        updateCallback->previous = nullptr;
+        updateCallback->next = nullptr;
+    }
+
     UpdateCallback::~UpdateCallback()
     {
-        sharedEngine->unscheduleUpdate(this);
+        if (list && sharedEngine) sharedEngine->unscheduleUpdate(this);
+    }
+
+    UpdateCallback& UpdateCallback::operator=(const UpdateCallback& other)
+    {
+        callback = other.callback;
+        setPriority(other.priority);
+
+        return *this;
+    }
+
+    void UpdateCallback::setPriority(int32_t newPriority)
+    {
+        if (priority == newPriority) return;
+
+        priority = newPriority;
+
+        if (list && sharedEngine)
+        {
+            sharedEngine->unscheduleUpdate(this);
+            sharedEngine->scheduleUpdate(this);
+        }
     }
 }
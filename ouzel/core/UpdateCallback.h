@@ -9,19 +9,54 @@
 namespace ouzel
 {
     class Engine;
+    class UpdateCallback;
+
+    // intrusive doubly linked list of the update callbacks with the same priority
+    class UpdateCallbackList
+    {
+        friend Engine;
+    public:
+        UpdateCallbackList(int32_t aPriority = 0): priority(aPriority) { }
+
+        int32_t getPriority() const { return priority; }
+        bool isEmpty() const { return first == nullptr; }
+
+        void pushBack(UpdateCallback* updateCallback);
+        void erase(UpdateCallback* updateCallback);
+
+    protected:
+        int32_t priority;
+        UpdateCallback* first = nullptr;
+        UpdateCallback* last = nullptr;
+    };
 
     class UpdateCallback
     {
         friend Engine;
+        friend UpdateCallbackList;
     public:
         static const int32_t PRIORITY_MAX = 0x1000;
 
         UpdateCallback(int32_t aPriority = 0): priority(aPriority) { }
         ~UpdateCallback();
 
+        // the copy is not scheduled
+        UpdateCallback(const UpdateCallback& other): callback(other.callback), priority(other.priority) { }
+        UpdateCallback& operator=(const UpdateCallback& other);
+
+        // a scheduled callback is called with the new priority from the next frame on
+        void setPriority(int32_t newPriority);
+        int32_t getPriority() const { return priority; }
+
+        bool isScheduled() const { return list != nullptr; }
+
         std::function<void(float)> callback;
 
     protected:
         int32_t priority;
+
+        UpdateCallbackList* list = nullptr;
+        UpdateCallback* previous = nullptr;
+        UpdateCallback* next = nullptr;
     };
 }
@@ -2,6 +2,7 @@
 // This file is part of the Ouzel engine.
 
 #include <cstdlib>
+#include <poll.h>
 #include <unistd.h>
 #include <GL/gl.h>
 #include <GL/glext.h>
@@ -52,14 +53,20 @@ namespace ouzel
 
                 if (sharedEngine->draw())
                 {
-                    while (sharedEngine->isActive())
+                    // while paused or idle, frames come at the idle frame rate, so wait for X events in the meantime
+                    if ((!sharedEngine->isRunning() || sharedEngine->getFramePacer()->isIdle()) &&
+                        !XPending(windowLinux->getDisplay()))
                     {
-                        // XNextEvent will block if there is no event pending, so don't call it if engine is running
-                        if (sharedEngine->isRunning() && !XPending(windowLinux->getDisplay()))
-                        {
-                            break;
-                        }
+                        pollfd displayPoll;
+                        displayPoll.fd = ConnectionNumber(windowLinux->getDisplay());
+                        displayPoll.events = POLLIN;
+                        displayPoll.revents = 0;
 
+                        poll(&displayPoll, 1, static_cast<int>(sharedEngine->getFramePacer()->getIdleFrameTime() * 1000.0f));
+                    }
+
+                    while (sharedEngine->isActive() && XPending(windowLinux->getDisplay()))
+                    {
                         XNextEvent(windowLinux->getDisplay(), &event);
 
                         switch (event.type)
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include "EventDispatcher.h"
+#include "core/Engine.h"
 
 namespace ouzel
 {
@@ -12,170 +13,369 @@ namespace ouzel
 
     EventDispatcher::~EventDispatcher()
     {
-    }
+        // event handlers that outlive the dispatcher must not remove themselves
+        for (EventHandler* eventHandler : eventHandlerAddList)
+        {
+            eventHandler->adding = false;
+        }
 
-    void EventDispatcher::dispatchEvents()
-    {
-        // erase all null event handlers from the list
-        for (auto i = eventHandlers.begin(); i != eventHandlers.end();)
+        for (const std::vector<EventHandler*>& eventHandlerTable : eventHandlerTables)
         {
-            if (*i)
-            {
-                ++i;
-            }
-            else
+            for (EventHandler* eventHandler : eventHandlerTable)
             {
-                i = eventHandlers.erase(i);
+                if (eventHandler) eventHandler->categories = 0;
             }
         }
+    }
 
-        if (!eventHandlerAddSet.empty())
+    void EventDispatcher::dispatchEvents()
+    {
+        if (dirtyCategories)
         {
-            for (const EventHandler* eventHandler : eventHandlerAddSet)
+            for (uint32_t i = 0; i < EventHandler::CATEGORY_COUNT; ++i)
             {
-                auto i = std::find(eventHandlers.begin(), eventHandlers.end(), eventHandler);
-
-                if (i == eventHandlers.end())
+                if (dirtyCategories & (1 << i))
                 {
-                    eventHandlers.push_back(eventHandler);
+                    std::vector<EventHandler*>& eventHandlerTable = eventHandlerTables[i];
+                    eventHandlerTable.erase(std::remove(eventHandlerTable.begin(), eventHandlerTable.end(), nullptr), eventHandlerTable.end());
                 }
             }
 
-            std::stable_sort(eventHandlers.begin(), eventHandlers.end(), [](const EventHandler* a, const EventHandler* b) {
-                return a->priority > b->priority;
-            });
+            dirtyCategories = 0;
         }
 
-        Event event;
+        if (!eventHandlerAddList.empty())
+        {
+            addEventHandlers();
+        }
 
+        // events posted by the handlers are dispatched in the same frame
         for (;;)
         {
+            if (eventBatchPosition >= eventBatch.size())
             {
-                std::lock_guard<std::mutex> lock(eventQueueMutex);
-                if (eventQueue.empty())
+                eventBatch.clear();
+                eventBatchPosition = 0;
+                eventQueue.popAll(eventBatch);
+
+                if (eventBatch.empty())
                 {
                     break;
                 }
 
-                event = eventQueue.front();
-                eventQueue.pop();
-            }
+                batchHistory = eventCoalescing && coalescedEventHistory;
 
-            bool propagate = true;
+                if (eventCoalescing)
+                {
+                    coalesceEvents();
+                }
+            }
 
-            for (const EventHandler* eventHandler : eventHandlers)
+            while (eventBatchPosition < eventBatch.size())
             {
-                if (eventHandler)
+                uint32_t i = eventBatchPosition++;
+
+                if (batchHistory)
                 {
-                    switch (event.type)
-                    {
-                        case Event::Type::KEY_DOWN:
-                        case Event::Type::KEY_UP:
-                        case Event::Type::KEY_REPEAT:
-                            if (eventHandler->keyboardHandler)
-                            {
-                                propagate = eventHandler->keyboardHandler(event.type, event.keyboardEvent);
-                            }
-                            break;
-
-                        case Event::Type::MOUSE_DOWN:
-                        case Event::Type::MOUSE_UP:
-                        case Event::Type::MOUSE_SCROLL:
-                        case Event::Type::MOUSE_MOVE:
-                            if (eventHandler->mouseHandler)
-                            {
-                                propagate = eventHandler->mouseHandler(event.type, event.mouseEvent);
-                            }
-                            break;
-                        case Event::Type::TOUCH_BEGIN:
-                        case Event::Type::TOUCH_MOVE:
-                        case Event::Type::TOUCH_END:
-                        case Event::Type::TOUCH_CANCEL:
-                            if (eventHandler->touchHandler)
-                            {
-                                propagate = eventHandler->touchHandler(event.type, event.touchEvent);
-                            }
-                            break;
-                        case Event::Type::GAMEPAD_CONNECT:
-                        case Event::Type::GAMEPAD_DISCONNECT:
-                        case Event::Type::GAMEPAD_BUTTON_CHANGE:
-                            if (eventHandler->gamepadHandler)
-                            {
-                                propagate = eventHandler->gamepadHandler(event.type, event.gamepadEvent);
-                            }
-                            break;
-                        case Event::Type::WINDOW_SIZE_CHANGE:
-                        case Event::Type::WINDOW_TITLE_CHANGE:
-                        case Event::Type::WINDOW_FULLSCREEN_CHANGE:
-                        case Event::Type::WINDOW_RESOLUTION_CHANGE:
-                            if (eventHandler->windowHandler)
-                            {
-                                propagate = eventHandler->windowHandler(event.type, event.windowEvent);
-                            }
-                            break;
-                        case Event::Type::ORIENTATION_CHANGE:
-                        case Event::Type::LOW_MEMORY:
-                        case Event::Type::OPEN_FILE:
-                            if (eventHandler->systemHandler)
-                            {
-                                propagate = eventHandler->systemHandler(event.type, event.systemEvent);
-                            }
-                            break;
-                        case Event::Type::UI_ENTER_NODE:
-                        case Event::Type::UI_LEAVE_NODE:
-                        case Event::Type::UI_PRESS_NODE:
-                        case Event::Type::UI_RELEASE_NODE:
-                        case Event::Type::UI_CLICK_NODE:
-                        case Event::Type::UI_DRAG_NODE:
-                        case Event::Type::UI_WIDGET_CHANGE:
-                            if (eventHandler->uiHandler)
-                            {
-                                propagate = eventHandler->uiHandler(event.type, event.uiEvent);
-                            }
-                            break;
-                        case Event::Type::USER:
-                            if (eventHandler->userHandler)
-                            {
-                                propagate = eventHandler->userHandler(event.type, event.userEvent);
-                            }
-                            break;
-                    }
+                    currentHistoryBegin = historyBegins[i];
+                    currentHistoryCount = historyBegins[i + 1] - historyBegins[i];
                 }
+
+                bool propagate = dispatchEvent(eventBatch[i]);
+
+                currentHistoryBegin = 0;
+                currentHistoryCount = 0;
+
+                // the rest of the events are dispatched in the next dispatchEvents call
+                if (!propagate)
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    static bool getCoalescingKey(const Event& event, uint64_t& deviceId, uint32_t& button)
+    {
+        switch (event.type)
+        {
+            case Event::Type::MOUSE_MOVE:
+                deviceId = 0;
+                button = 0;
+                return true;
+            case Event::Type::TOUCH_MOVE:
+                deviceId = event.touchEvent.touchId;
+                button = 0;
+                return true;
+            case Event::Type::GAMEPAD_BUTTON_CHANGE:
+                deviceId = reinterpret_cast<uintptr_t>(event.gamepadEvent.gamepad);
+                button = static_cast<uint32_t>(event.gamepadEvent.button);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // returns false if the events can not be merged without losing information
+    static bool mergeEvent(Event& event, const Event& nextEvent)
+    {
+        switch (event.type)
+        {
+            case Event::Type::MOUSE_MOVE:
+                if (event.mouseEvent.modifiers != nextEvent.mouseEvent.modifiers) return false;
+
+                event.mouseEvent.difference += nextEvent.mouseEvent.difference;
+                event.mouseEvent.position = nextEvent.mouseEvent.position;
+                return true;
+            case Event::Type::TOUCH_MOVE:
+                event.touchEvent.difference += nextEvent.touchEvent.difference;
+                event.touchEvent.position = nextEvent.touchEvent.position;
+                return true;
+            case Event::Type::GAMEPAD_BUTTON_CHANGE:
+                // a press or a release is never merged away
+                if (nextEvent.gamepadEvent.pressed != nextEvent.gamepadEvent.previousPressed) return false;
+
+                event.gamepadEvent.pressed = nextEvent.gamepadEvent.pressed;
+                event.gamepadEvent.value = nextEvent.gamepadEvent.value;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void EventDispatcher::coalesceEvents()
+    {
+        coalescedEvents.clear();
+        eventHistory.clear();
+
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < eventBatch.size(); ++i)
+        {
+            Event& event = eventBatch[i];
+
+            uint64_t deviceId;
+            uint32_t button;
+
+            if (!getCoalescingKey(event, deviceId, button))
+            {
+                coalescedEvents.clear();
+                if (count != i) eventBatch[count] = std::move(event);
+                ++count;
+                continue;
+            }
+
+            // there are only a few devices, so a linear search is the fastest
+            auto coalescedEvent = std::find_if(coalescedEvents.begin(), coalescedEvents.end(), [&event, deviceId, button](const CoalescedEvent& e) {
+                return e.type == event.type && e.deviceId == deviceId && e.button == button;
+            });
+
+            if (coalescedEvent != coalescedEvents.end() &&
+                mergeEvent(eventBatch[coalescedEvent->batchIndex], event))
+            {
+                if (coalescedEventHistory) eventHistory.push_back({coalescedEvent->batchIndex, std::move(event)});
+                continue;
+            }
+
+            if (coalescedEvent != coalescedEvents.end())
+            {
+                coalescedEvent->batchIndex = count;
+            }
+            else
+            {
+                coalescedEvents.push_back({event.type, deviceId, button, count});
+            }
+
+            if (coalescedEventHistory) eventHistory.push_back({count, event});
+            if (count != i) eventBatch[count] = std::move(event);
+            ++count;
+        }
+
+        eventBatch.resize(count);
+
+        if (coalescedEventHistory)
+        {
+            // the samples of one event are not next to each other if the events of several devices were interleaved
+            std::stable_sort(eventHistory.begin(), eventHistory.end(), [](const HistoryEvent& a, const HistoryEvent& b) {
+                return a.batchIndex < b.batchIndex;
+            });
+
+            historyBegins.assign(count + 1, 0);
+
+            for (const HistoryEvent& historyEvent : eventHistory)
+            {
+                ++historyBegins[historyEvent.batchIndex + 1];
             }
 
-            if (!propagate)
+            for (uint32_t i = 0; i < count; ++i)
             {
-                break;
+                historyBegins[i + 1] += historyBegins[i];
             }
         }
     }
 
-    void EventDispatcher::addEventHandler(const EventHandler* eventHandler)
+    void EventDispatcher::addEventHandlers()
     {
-        eventHandlerAddSet.insert(eventHandler);
+        for (EventHandler* eventHandler : eventHandlerAddList)
+        {
+            // removed before it was added or added twice
+            if (!eventHandler->adding) continue;
+
+            eventHandler->adding = false;
+
+            uint32_t categories = eventHandler->callback ? eventHandler->callbackCategories : 0;
+            if (eventHandler->keyboardHandler) categories |= EventHandler::KEYBOARD;
+            if (eventHandler->mouseHandler) categories |= EventHandler::MOUSE;
+            if (eventHandler->touchHandler) categories |= EventHandler::TOUCH;
+            if (eventHandler->gamepadHandler) categories |= EventHandler::GAMEPAD;
+            if (eventHandler->windowHandler) categories |= EventHandler::WINDOW;
+            if (eventHandler->systemHandler) categories |= EventHandler::SYSTEM;
+            if (eventHandler->uiHandler) categories |= EventHandler::UI;
+            if (eventHandler->userHandler) categories |= EventHandler::USER;
+
+            eventHandler->categories = categories;
+
+            for (uint32_t i = 0; i < EventHandler::CATEGORY_COUNT; ++i)
+            {
+                if (categories & (1 << i))
+                {
+                    std::vector<EventHandler*>& eventHandlerTable = eventHandlerTables[i];
+
+                    // after the event handlers with the same priority
+                    auto position = std::upper_bound(eventHandlerTable.begin(), eventHandlerTable.end(), eventHandler,
+                                                     [](const EventHandler* a, const EventHandler* b) {
+                        return a->priority > b->priority;
+                    });
+
+                    eventHandlerTable.insert(position, eventHandler);
+                }
+            }
+        }
+
+        eventHandlerAddList.clear();
     }
 
-    void EventDispatcher::removeEventHandler(const EventHandler* eventHandler)
+    bool EventDispatcher::dispatchEvent(const Event& event)
     {
-        auto vectorIterator = std::find(eventHandlers.begin(), eventHandlers.end(), eventHandler);
+        EventHandler::Category category = EventHandler::getCategory(event.type);
+
+        uint32_t index = 0;
+        while (!(category & (1 << index))) ++index;
 
-        if (vectorIterator != eventHandlers.end())
+        bool propagate = true;
+
+        for (const EventHandler* eventHandler : eventHandlerTables[index])
+        {
+            if (!eventHandler) continue;
+
+            if (eventHandler->callback && (eventHandler->callbackCategories & category))
+            {
+                propagate = eventHandler->callback(event, eventHandler->userData);
+            }
+            else
+            {
+                switch (category)
+                {
+                    case EventHandler::KEYBOARD:
+                        if (eventHandler->keyboardHandler)
+                        {
+                            propagate = eventHandler->keyboardHandler(event.type, event.keyboardEvent);
+                        }
+                        break;
+                    case EventHandler::MOUSE:
+                        if (eventHandler->mouseHandler)
+                        {
+                            propagate = eventHandler->mouseHandler(event.type, event.mouseEvent);
+                        }
+                        break;
+                    case EventHandler::TOUCH:
+                        if (eventHandler->touchHandler)
+                        {
+                            propagate = eventHandler->touchHandler(event.type, event.touchEvent);
+                        }
+                        break;
+                    case EventHandler::GAMEPAD:
+                        if (eventHandler->gamepadHandler)
+                        {
+                            propagate = eventHandler->gamepadHandler(event.type, event.gamepadEvent);
+                        }
+                        break;
+                    case EventHandler::WINDOW:
+                        if (eventHandler->windowHandler)
+                        {
+                            propagate = eventHandler->windowHandler(event.type, event.windowEvent);
+                        }
+                        break;
+                    case EventHandler::SYSTEM:
+                        if (eventHandler->systemHandler)
+                        {
+                            propagate = eventHandler->systemHandler(event.type, event.systemEvent);
+                        }
+                        break;
+                    case EventHandler::UI:
+                        if (eventHandler->uiHandler)
+                        {
+                            propagate = eventHandler->uiHandler(event.type, event.uiEvent);
+                        }
+                        break;
+                    case EventHandler::USER:
+                        if (eventHandler->userHandler)
+                        {
+                            propagate = eventHandler->userHandler(event.type, event.userEvent);
+                        }
+                        break;
+                }
+            }
+        }
+
+        return propagate;
+    }
+
+    void EventDispatcher::addEventHandler(EventHandler* eventHandler)
+    {
+        if (!eventHandler->categories && !eventHandler->adding)
         {
-            *vectorIterator = nullptr;
+            eventHandler->adding = true;
+            eventHandlerAddList.push_back(eventHandler);
         }
+    }
 
-        auto setIterator = eventHandlerAddSet.find(eventHandler);
+    void EventDispatcher::removeEventHandler(EventHandler* eventHandler)
+    {
+        if (eventHandler->adding)
+        {
+            eventHandlerAddList.erase(std::remove(eventHandlerAddList.begin(), eventHandlerAddList.end(), eventHandler), eventHandlerAddList.end());
+            eventHandler->adding = false;
+        }
 
-        if (setIterator != eventHandlerAddSet.end())
+        for (uint32_t i = 0; i < EventHandler::CATEGORY_COUNT; ++i)
         {
-            eventHandlerAddSet.erase(setIterator);
+            if (eventHandler->categories & (1 << i))
+            {
+                std::vector<EventHandler*>& eventHandlerTable = eventHandlerTables[i];
+                auto position = std::find(eventHandlerTable.begin(), eventHandlerTable.end(), eventHandler);
+
+                if (position != eventHandlerTable.end())
+                {
+                    *position = nullptr;
+                    dirtyCategories |= (1 << i);
+                }
+            }
         }
+
+        eventHandler->categories = 0;
     }
 
-    void EventDispatcher::postEvent(const Event& event)
+    bool EventDispatcher::postEvent(const Event& event)
     {
-        std::lock_guard<std::mutex> lock(eventQueueMutex);
+        if (!eventQueue.push(event))
+        {
+            return false;
+        }
+
+        // an idle update thread handles the event right away
+        sharedEngine->getFramePacer()->wake();
 
-        eventQueue.push(event);
+        return true;
     }
 }
@@ -4,13 +4,11 @@
 #pragma once
 
 #include <vector>
-#include <mutex>
-#include <queue>
-#include <set>
 #include <cstdint>
 #include "utils/Noncopyable.h"
 #include "events/Event.h"
 #include "events/EventHandler.h"
+#include "events/EventQueue.h"
 
 namespace ouzel
 {
@@ -24,18 +22,70 @@ namespace ouzel
 
         void dispatchEvents();
 
-        void addEventHandler(const EventHandler* eventHandler);
-        void removeEventHandler(const EventHandler* eventHandler);
+        // the event handler gets events from the next dispatchEvents call on
+        void addEventHandler(EventHandler* eventHandler);
+        void removeEventHandler(EventHandler* eventHandler);
 
-        void postEvent(const Event& event);
+        // can be called from any thread, returns false if the event queue was full and the event was dropped
+        bool postEvent(const Event& event);
+
+        void setOverflowPolicy(EventQueue::OverflowPolicy newOverflowPolicy) { eventQueue.setOverflowPolicy(newOverflowPolicy); }
+        EventQueue::OverflowPolicy getOverflowPolicy() const { return eventQueue.getOverflowPolicy(); }
+        uint32_t getDroppedEventCount() const { return eventQueue.getDroppedCount(); }
+
+        // merges the mouse moves, the moves of every touch and the value changes of every gamepad button that are
+        // queued one after another (for the same device) into a single event with the latest position or value and
+        // the accumulated difference, any other event ends the merging
+        void setEventCoalescing(bool newEventCoalescing) { eventCoalescing = newEventCoalescing; }
+        bool isCoalescingEvents() const { return eventCoalescing; }
+
+        // keeps the merged events, so handlers can go through all the samples (for example for gesture recognition)
+        void setCoalescedEventHistory(bool newCoalescedEventHistory) { coalescedEventHistory = newCoalescedEventHistory; }
+        bool isKeepingCoalescedEventHistory() const { return coalescedEventHistory; }
+
+        // the events merged into the event that is being dispatched, oldest first, only if the history is kept
+        uint32_t getCoalescedEventCount() const { return currentHistoryCount; }
+        const Event& getCoalescedEvent(uint32_t index) const { return eventHistory[currentHistoryBegin + index].event; }
 
     protected:
         EventDispatcher();
 
-        std::vector<const EventHandler*> eventHandlers;
-        std::set<const EventHandler*> eventHandlerAddSet;
+        void coalesceEvents();
+        // every event handler gets the event, returns the result of the last one
+        bool dispatchEvent(const Event& event);
+
+        void addEventHandlers();
+
+        // sorted by descending priority, removed event handlers are set to null until the next dispatchEvents call
+        std::vector<EventHandler*> eventHandlerTables[EventHandler::CATEGORY_COUNT];
+        uint32_t dirtyCategories = 0;
+        std::vector<EventHandler*> eventHandlerAddList;
+
+        EventQueue eventQueue;
+        std::vector<Event> eventBatch;
+        uint32_t eventBatchPosition = 0;
+        bool batchHistory = false;
+
+        struct CoalescedEvent
+        {
+            Event::Type type;
+            uint64_t deviceId;
+            uint32_t button;
+            uint32_t batchIndex;
+        };
+
+        struct HistoryEvent
+        {
+            uint32_t batchIndex;
+            Event event;
+        };
 
-        std::mutex eventQueueMutex;
-        std::queue<Event> eventQueue;
+        bool eventCoalescing = false;
+        bool coalescedEventHistory = false;
+        std::vector<CoalescedEvent> coalescedEvents;
+        std::vector<HistoryEvent> eventHistory;
+        std::vector<uint32_t> historyBegins;
+        uint32_t currentHistoryBegin = 0;
+        uint32_t currentHistoryCount = 0;
     };
 }
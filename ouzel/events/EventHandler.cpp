@@ -7,8 +7,53 @@
 
 namespace ouzel
 {
+    EventHandler::Category EventHandler::getCategory(Event::Type type)
+    {
+        switch (type)
+        {
+            case Event::Type::KEY_DOWN:
+            case Event::Type::KEY_UP:
+            case Event::Type::KEY_REPEAT:
+                return KEYBOARD;
+            case Event::Type::MOUSE_DOWN:
+            case Event::Type::MOUSE_UP:
+            case Event::Type::MOUSE_SCROLL:
+            case Event::Type::MOUSE_MOVE:
+                return MOUSE;
+            case Event::Type::TOUCH_BEGIN:
+            case Event::Type::TOUCH_MOVE:
+            case Event::Type::TOUCH_END:
+            case Event::Type::TOUCH_CANCEL:
+                return TOUCH;
+            case Event::Type::GAMEPAD_CONNECT:
+            case Event::Type::GAMEPAD_DISCONNECT:
+            case Event::Type::GAMEPAD_BUTTON_CHANGE:
+                return GAMEPAD;
+            case Event::Type::WINDOW_SIZE_CHANGE:
+            case Event::Type::WINDOW_TITLE_CHANGE:
+            case Event::Type::WINDOW_FULLSCREEN_CHANGE:
+            case Event::Type::WINDOW_RESOLUTION_CHANGE:
+                return WINDOW;
+            case Event::Type::ORIENTATION_CHANGE:
+            case Event::Type::LOW_MEMORY:
+            case Event::Type::OPEN_FILE:
+                return SYSTEM;
+            case Event::Type::UI_ENTER_NODE:
+            case Event::Type::UI_LEAVE_NODE:
+            case Event::Type::UI_PRESS_NODE:
+            case Event::Type::UI_RELEASE_NODE:
+            case Event::Type::UI_CLICK_NODE:
+            case Event::Type::UI_DRAG_NODE:
+            case Event::Type::UI_WIDGET_CHANGE:
+                return UI;
+            case Event::Type::USER:
+            default:
+                return USER;
+        }
+    }
+
     EventHandler::~EventHandler()
     {
-        sharedEngine->getEventDispatcher()->removeEventHandler(this);
+        if ((categories || adding) && sharedEngine) sharedEngine->getEventDispatcher()->removeEventHandler(this);
     }
 }
@@ -17,9 +17,27 @@ namespace ouzel
     public:
         static const int32_t PRIORITY_MAX = 0x1000;
 
+        enum Category
+        {
+            KEYBOARD    = 0x01,
+            MOUSE       = 0x02,
+            TOUCH       = 0x04,
+            GAMEPAD     = 0x08,
+            WINDOW      = 0x10,
+            SYSTEM      = 0x20,
+            UI          = 0x40,
+            USER        = 0x80
+        };
+
+        static const uint32_t CATEGORY_COUNT = 8;
+
+        static Category getCategory(Event::Type type);
+
         EventHandler(int32_t aPriority = 0): priority(aPriority) { }
         ~EventHandler();
 
+        // the handlers have to be set before the event handler is added to the dispatcher,
+        // it only gets the events of the categories that had a handler at that time
         std::function<bool(Event::Type, const KeyboardEvent&)> keyboardHandler;
         std::function<bool(Event::Type, const MouseEvent&)> mouseHandler;
         std::function<bool(Event::Type, const TouchEvent&)> touchHandler;
@@ -29,7 +47,27 @@ namespace ouzel
         std::function<bool(Event::Type, const UIEvent&)> uiHandler;
         std::function<bool(Event::Type, const UserEvent&)> userHandler;
 
+        // a plain function that is called instead of the handlers above for the events of the given categories,
+        // it is cheaper to call than a std::function
+        typedef bool (*Callback)(const Event& event, void* userData);
+
+        void setCallback(uint32_t newCallbackCategories, Callback newCallback, void* newUserData)
+        {
+            callbackCategories = newCallbackCategories;
+            callback = newCallback;
+            userData = newUserData;
+        }
+
+        int32_t getPriority() const { return priority; }
+
     protected:
         int32_t priority;
+
+        uint32_t callbackCategories = 0;
+        Callback callback = nullptr;
+        void* userData = nullptr;
+
+        uint32_t categories = 0; // categories whose tables this is in
+        bool adding = false;
     };
 }
@@ -0,0 +1,92 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <iterator>
+#include "EventQueue.h"
+
+namespace ouzel
+{
+    EventQueue::EventQueue(uint32_t aCapacity):
+        overflowPolicy(OverflowPolicy::SPILL), tail(0), spilling(false), droppedCount(0), spilledCount(0)
+    {
+        uint32_t capacity = 2;
+        while (capacity < aCapacity) capacity <<= 1;
+
+        mask = capacity - 1;
+        slots.reset(new Slot[capacity]);
+
+        for (uint32_t i = 0; i < capacity; ++i)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool EventQueue::push(const Event& event)
+    {
+        if (!spilling.load(std::memory_order_acquire))
+        {
+            uint32_t position = tail.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                Slot& slot = slots[position & mask];
+                uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+                int32_t difference = static_cast<int32_t>(sequence - position);
+
+                if (difference == 0)
+                {
+                    if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        slot.event = event;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    break; // full
+                }
+                else
+                {
+                    position = tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        if (overflowPolicy == OverflowPolicy::DROP)
+        {
+            ++droppedCount;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(spillMutex);
+        spilledEvents.push_back(event);
+        spilling.store(true, std::memory_order_release);
+        ++spilledCount;
+
+        return true;
+    }
+
+    void EventQueue::popAll(std::vector<Event>& events)
+    {
+        for (;;)
+        {
+            Slot& slot = slots[head & mask];
+
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1) break;
+
+            events.push_back(std::move(slot.event));
+            slot.sequence.store(head + mask + 1, std::memory_order_release);
+            ++head;
+        }
+
+        if (spilling.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(spillMutex);
+
+            std::move(spilledEvents.begin(), spilledEvents.end(), std::back_inserter(events));
+            spilledEvents.clear();
+            spilling.store(false, std::memory_order_release);
+        }
+    }
+}
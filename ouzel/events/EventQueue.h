@@ -0,0 +1,66 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "utils/Noncopyable.h"
+#include "events/Event.h"
+
+namespace ouzel
+{
+    // Bounded lock-free queue with multiple producers and a single consumer.
+    // Every slot has a sequence number, a producer claims a slot by advancing the tail with a compare-and-swap and
+    // publishes the event by storing the next sequence number, so producers never wait for each other or the consumer.
+    class EventQueue: public Noncopyable
+    {
+    public:
+        enum class OverflowPolicy
+        {
+            SPILL, // events that do not fit are stored in a locked list until the consumer takes them
+            DROP // events that do not fit are discarded and counted
+        };
+
+        // the capacity is rounded up to a power of two
+        EventQueue(uint32_t aCapacity = 1024);
+
+        void setOverflowPolicy(OverflowPolicy newOverflowPolicy) { overflowPolicy = newOverflowPolicy; }
+        OverflowPolicy getOverflowPolicy() const { return overflowPolicy; }
+
+        uint32_t getCapacity() const { return mask + 1; }
+        uint32_t getDroppedCount() const { return droppedCount; }
+        uint32_t getSpilledCount() const { return spilledCount; }
+
+        // can be called from any thread, returns false if the event was dropped
+        bool push(const Event& event);
+
+        // moves all published events to the end of the vector in the order they were pushed, must only be called by one thread
+        void popAll(std::vector<Event>& events);
+
+    protected:
+        struct Slot
+        {
+            std::atomic<uint32_t> sequence;
+            Event event;
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        uint32_t mask;
+        std::atomic<OverflowPolicy> overflowPolicy;
+
+        std::atomic<uint32_t> tail;
+        uint32_t head = 0;
+
+        // once an event is spilled, the following ones are spilled too, so that they are not taken before it
+        std::atomic<bool> spilling;
+        std::mutex spillMutex;
+        std::vector<Event> spilledEvents;
+
+        std::atomic<uint32_t> droppedCount;
+        std::atomic<uint32_t> spilledCount;
+    };
+}
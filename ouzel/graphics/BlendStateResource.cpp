@@ -56,5 +56,14 @@ namespace ouzel
 
             return true;
         }
+
+        bool BlendStateResource::reload()
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            pendingData.dirty |= 0x01;
+
+            return true;
+        }
     } // namespace graphics
 } // namespace ouzel
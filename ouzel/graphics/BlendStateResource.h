@@ -37,6 +37,7 @@ namespace ouzel
         protected:
             BlendStateResource();
             virtual bool upload() override;
+            virtual bool reload() override;
 
             struct Data
             {
@@ -70,5 +70,11 @@ namespace ouzel
             
             return true;
         }
+
+        void Buffer::setResidency(Residency newResidency)
+        {
+            residency = newResidency;
+            resource->setResidency(newResidency);
+        }
     } // namespace graphics
 } // namespace ouzel
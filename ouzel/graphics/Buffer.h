@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include "utils/Noncopyable.h"
+#include "graphics/Resource.h"
 
 namespace ouzel
 {
@@ -35,11 +36,17 @@ namespace ouzel
 
             bool setData(const void* newData, uint32_t newSize);
 
+            // should be set before the buffer is initialized, buffers can only be reloaded after the graphics context
+            // is lost if their data is kept
+            void setResidency(Residency newResidency);
+            Residency getResidency() const { return residency; }
+
         private:
             BufferResource* resource = nullptr;
 
             Buffer::Usage usage;
             bool dynamic = true;
+            Residency residency = Residency::DEFAULT;
             uint32_t size = 0;
         };
     } // namespace graphics
@@ -2,6 +2,8 @@
 // This file is part of the Ouzel engine.
 
 #include "BufferResource.h"
+#include "utils/Log.h"
+#include "utils/MemoryTracker.h"
 
 namespace ouzel
 {
@@ -13,6 +15,8 @@ namespace ouzel
 
         BufferResource::~BufferResource()
         {
+            MemoryTracker::update(MemoryTracker::Tag::GRAPHICS, cpuMemorySize, 0);
+            MemoryTracker::update(MemoryTracker::Tag::GPU, gpuMemorySize, 0);
         }
 
         bool BufferResource::init(Buffer::Usage newUsage, bool newDynamic)
@@ -46,6 +50,8 @@ namespace ouzel
 
             pendingData.dirty |= ATTRIBUTES | DATA;
 
+            updateMemoryUsage();
+
             return true;
         }
 
@@ -70,9 +76,18 @@ namespace ouzel
 
             pendingData.dirty |= ATTRIBUTES | DATA;
 
+            updateMemoryUsage();
+
             return true;
         }
 
+        void BufferResource::setResidency(Residency newResidency)
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            residency = newResidency;
+        }
+
         bool BufferResource::upload()
         {
             std::lock_guard<std::mutex> lock(uploadMutex);
@@ -89,9 +104,59 @@ namespace ouzel
             if (data.dirty & DATA)
             {
                 data.data = std::move(pendingData.data);
+                pendingData.data.clear();
+                dataReleased = false;
+
+                updateMemoryUsage();
+                MemoryTracker::update(MemoryTracker::Tag::GPU, gpuMemorySize, data.data.size());
             }
 
             return true;
         }
+
+        void BufferResource::releaseData()
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            if (residency == Residency::KEEP ||
+                (residency == Residency::DEFAULT && data.dynamic))
+            {
+                return;
+            }
+
+            if (!data.data.empty())
+            {
+                std::vector<uint8_t>().swap(data.data);
+                dataReleased = true;
+
+                updateMemoryUsage();
+            }
+        }
+
+        bool BufferResource::reload()
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            if (!(pendingData.dirty & DATA))
+            {
+                if (dataReleased)
+                {
+                    Log(Log::Level::ERR) << "Failed to reload buffer, its data was released";
+                    return false;
+                }
+
+                pendingData.data = data.data;
+                updateMemoryUsage();
+            }
+
+            pendingData.dirty |= ATTRIBUTES | DATA;
+
+            return true;
+        }
+
+        void BufferResource::updateMemoryUsage()
+        {
+            MemoryTracker::update(MemoryTracker::Tag::GRAPHICS, cpuMemorySize, data.data.capacity() + pendingData.data.capacity());
+        }
     } // namespace graphics
 } // namespace ouzel
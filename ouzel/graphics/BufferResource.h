@@ -26,11 +26,16 @@ namespace ouzel
 
             bool setData(const void* newData, uint32_t newSize);
 
+            void setResidency(Residency newResidency);
+
             Buffer::Usage getUsage() const { return data.usage; }
 
         protected:
             BufferResource();
             virtual bool upload() override;
+            virtual void releaseData() override;
+            virtual bool reload() override;
+            void updateMemoryUsage();
 
             enum Dirty
             {
@@ -49,6 +54,12 @@ namespace ouzel
             Data data;
             std::mutex uploadMutex;
 
+            Residency residency = Residency::DEFAULT;
+            bool dataReleased = false;
+
+            size_t cpuMemorySize = 0;
+            size_t gpuMemorySize = 0;
+
         private:
             Data pendingData;
         };
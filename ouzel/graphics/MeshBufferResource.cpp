@@ -136,5 +136,14 @@ namespace ouzel
             
             return true;
         }
+
+        bool MeshBufferResource::reload()
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            pendingData.dirty |= INDEX_ATTRIBUTES | INDEX_BUFFER | VERTEX_ATTRIBUTES | VERTEX_BUFFER;
+
+            return true;
+        }
     } // namespace graphics
 } // namespace ouzel
@@ -41,6 +41,7 @@ namespace ouzel
             MeshBufferResource();
             void updateVertexSize();
             virtual bool upload() override;
+            virtual bool reload() override;
 
             enum Dirty
             {
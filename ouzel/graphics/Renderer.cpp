@@ -109,8 +109,13 @@ namespace ouzel
                 }
 #endif
 
-                drawQueue = std::move(activeDrawQueue);
-                activeDrawQueue.reserve(drawQueue.size());
+                drawQueue.swap(activeDrawQueue);
+                shaderConstants.swap(activeShaderConstants);
+                shaderConstantData.swap(activeShaderConstantData);
+
+                activeDrawQueue.clear();
+                activeShaderConstants.clear();
+                activeShaderConstantData.clear();
 
                 activeDrawQueueFinished = false;
             }
@@ -133,6 +138,8 @@ namespace ouzel
                 {
                     return false;
                 }
+
+                resource->releaseData();
             }
 
             ++currentFrame;
@@ -215,10 +222,32 @@ namespace ouzel
             }
         }
 
+        bool Renderer::reloadResources()
+        {
+            std::lock_guard<std::mutex> lock(resourceMutex);
+
+            bool result = true;
+
+            for (const std::unique_ptr<Resource>& resource : resources)
+            {
+                if (!resource->reload())
+                {
+                    result = false;
+                    continue;
+                }
+
+                resourceUploadSet.insert(resource.get());
+            }
+
+            dirty = true;
+
+            return result;
+        }
+
         bool Renderer::addDrawCommand(const std::vector<std::shared_ptr<Texture>>& textures,
                                       const std::shared_ptr<Shader>& shader,
-                                      const std::vector<std::vector<float>>& pixelShaderConstants,
-                                      const std::vector<std::vector<float>>& vertexShaderConstants,
+                                      const FrameVector<FrameVector<float>>& pixelShaderConstants,
+                                      const FrameVector<FrameVector<float>>& vertexShaderConstants,
                                       const std::shared_ptr<BlendState>& blendState,
                                       const std::shared_ptr<MeshBuffer>& meshBuffer,
                                       uint32_t indexCount,
@@ -252,18 +281,13 @@ namespace ouzel
                 return false;
             }
 
-            std::vector<TextureResource*> drawTextures;
-
-            for (const std::shared_ptr<Texture>& texture : textures)
-            {
-                if (texture) drawTextures.push_back(texture->getResource());
-            }
-
-            activeDrawQueue.push_back({
-                drawTextures,
+            DrawCommand drawCommand = {
+                {},
                 shader->getResource(),
-                pixelShaderConstants,
-                vertexShaderConstants,
+                static_cast<uint32_t>(activeShaderConstants.size()),
+                static_cast<uint32_t>(pixelShaderConstants.size()),
+                static_cast<uint32_t>(activeShaderConstants.size() + pixelShaderConstants.size()),
+                static_cast<uint32_t>(vertexShaderConstants.size()),
                 blendState->getResource(),
                 meshBuffer->getResource(),
                 (indexCount > 0) ? indexCount : (meshBuffer->getIndexBuffer()->getSize() / meshBuffer->getIndexSize()) - startIndex,
@@ -276,7 +300,30 @@ namespace ouzel
                 wireframe,
                 scissorTestEnabled,
                 scissorTest
-            });
+            };
+
+            uint32_t layer = 0;
+
+            for (const std::shared_ptr<Texture>& texture : textures)
+            {
+                if (layer >= Texture::LAYERS) break;
+                if (texture) drawCommand.textures[layer++] = texture->getResource();
+            }
+
+            // the frame vectors die with the frame, while the draw command is used by the render thread later
+            for (const FrameVector<float>& pixelShaderConstant : pixelShaderConstants)
+            {
+                activeShaderConstants.push_back({static_cast<uint32_t>(activeShaderConstantData.size()), static_cast<uint32_t>(pixelShaderConstant.size())});
+                activeShaderConstantData.insert(activeShaderConstantData.end(), pixelShaderConstant.begin(), pixelShaderConstant.end());
+            }
+
+            for (const FrameVector<float>& vertexShaderConstant : vertexShaderConstants)
+            {
+                activeShaderConstants.push_back({static_cast<uint32_t>(activeShaderConstantData.size()), static_cast<uint32_t>(vertexShaderConstant.size())});
+                activeShaderConstantData.insert(activeShaderConstantData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
+            }
+
+            activeDrawQueue.push_back(drawCommand);
 
             return true;
         }
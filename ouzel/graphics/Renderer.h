@@ -14,6 +14,7 @@
 #include <condition_variable>
 #include "utils/Types.h"
 #include "utils/Noncopyable.h"
+#include "core/FrameAllocator.h"
 #include "math/Rectangle.h"
 #include "math/Matrix4.h"
 #include "math/Size2.h"
@@ -102,12 +103,15 @@ namespace ouzel
             virtual BufferResource* createBuffer() = 0;
             virtual void uploadResource(Resource* resource);
             virtual void deleteResource(Resource* resource);
+            // must be called by the thread that owns the graphics context after the context was lost and created again,
+            // all resources are uploaded again on the next frame
+            virtual bool reloadResources();
 
             bool getRefillDrawQueue() const { return refillDrawQueue; }
             bool addDrawCommand(const std::vector<std::shared_ptr<Texture>>& textures,
                                 const std::shared_ptr<Shader>& shader,
-                                const std::vector<std::vector<float>>& pixelShaderConstants,
-                                const std::vector<std::vector<float>>& vertexShaderConstants,
+                                const FrameVector<FrameVector<float>>& pixelShaderConstants,
+                                const FrameVector<FrameVector<float>>& vertexShaderConstants,
                                 const std::shared_ptr<BlendState>& blendState,
                                 const std::shared_ptr<MeshBuffer>& meshBuffer,
                                 uint32_t indexCount = 0,
@@ -189,12 +193,22 @@ namespace ouzel
 
             bool verticalSync = true;
 
+            // range of floats in the shader constant data of the draw queue
+            struct ShaderConstant
+            {
+                uint32_t offset;
+                uint32_t size;
+            };
+
             struct DrawCommand
             {
-                std::vector<TextureResource*> textures;
+                TextureResource* textures[Texture::LAYERS];
                 ShaderResource* shader;
-                std::vector<std::vector<float>> pixelShaderConstants;
-                std::vector<std::vector<float>> vertexShaderConstants;
+                // ranges of shaderConstants, so that draw commands do not allocate
+                uint32_t firstPixelShaderConstant;
+                uint32_t pixelShaderConstantCount;
+                uint32_t firstVertexShaderConstant;
+                uint32_t vertexShaderConstantCount;
                 BlendStateResource* blendState;
                 MeshBufferResource* meshBuffer;
                 uint32_t indexCount;
@@ -218,6 +232,8 @@ namespace ouzel
             std::atomic<bool> refillDrawQueue;
 
             std::vector<DrawCommand> drawQueue;
+            std::vector<ShaderConstant> shaderConstants;
+            std::vector<float> shaderConstantData;
 
             Matrix4 projectionTransform;
             Matrix4 renderTargetProjectionTransform;
@@ -253,7 +269,10 @@ namespace ouzel
             bool clearColorBuffer = true;
             bool clearDepthBuffer = false;
 
+            // filled by the update thread and swapped with the queue of the render thread, so the memory is reused
             std::vector<DrawCommand> activeDrawQueue;
+            std::vector<ShaderConstant> activeShaderConstants;
+            std::vector<float> activeShaderConstantData;
 
             std::queue<std::string> screenshotQueue;
             std::mutex screenshotMutex;
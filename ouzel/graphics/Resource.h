@@ -9,6 +9,14 @@ namespace ouzel
     {
         class Renderer;
 
+        // what happens to the CPU copy of the data of a texture or a buffer after it has been uploaded
+        enum class Residency
+        {
+            DEFAULT, // released for static resources, kept for dynamic ones
+            KEEP,
+            RELEASE
+        };
+
         class Resource
         {
             friend Renderer;
@@ -18,6 +26,10 @@ namespace ouzel
 
         protected:
             virtual bool upload() = 0;
+            // called after a successful upload
+            virtual void releaseData() {}
+            // the objects of the backend were lost with the graphics context, they are created again on the next upload
+            virtual bool reload() = 0;
         };
     } // graphics
 } // ouzel
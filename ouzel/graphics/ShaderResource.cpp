@@ -92,5 +92,19 @@ namespace ouzel
 
             return true;
         }
+
+        bool ShaderResource::reload()
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            if (!pendingData.dirty)
+            {
+                pendingData = data;
+            }
+
+            pendingData.dirty = 0x01;
+
+            return true;
+        }
     } // namespace graphics
 } // namespace ouzel
@@ -41,6 +41,7 @@ namespace ouzel
         protected:
             ShaderResource();
             virtual bool upload() override;
+            virtual bool reload() override;
 
             struct Data
             {
@@ -63,6 +63,8 @@ namespace ouzel
                 return false;
             }
 
+            resource->setSourceFilename(filename);
+
             sharedEngine->getRenderer()->uploadResource(resource);
 
             return true;
@@ -114,6 +116,12 @@ namespace ouzel
             return true;
         }
 
+        void Texture::setResidency(Residency newResidency)
+        {
+            residency = newResidency;
+            resource->setResidency(newResidency);
+        }
+
         void Texture::setClearColorBuffer(bool clear)
         {
             clearColorBuffer = clear;
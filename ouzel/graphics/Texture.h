@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include "utils/Noncopyable.h"
+#include "graphics/Resource.h"
 #include "math/Color.h"
 #include "math/Size2.h"
 
@@ -47,6 +48,11 @@ namespace ouzel
 
             bool isDynamic() const { return dynamic; }
 
+            // should be set before the texture is initialized, textures that are not loaded from a file
+            // can only be reloaded after the graphics context is lost if their data is kept
+            void setResidency(Residency newResidency);
+            Residency getResidency() const { return residency; }
+
             uint32_t getSampleCount() const { return sampleCount; }
             uint32_t getDepth() const { return depth; }
 
@@ -66,6 +72,7 @@ namespace ouzel
 
             Size2 size;
             bool dynamic = false;
+            Residency residency = Residency::DEFAULT;
             bool mipmaps = false;
             bool renderTarget = false;
             bool clearColorBuffer = true;
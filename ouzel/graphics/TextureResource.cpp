@@ -6,6 +6,8 @@
 #include "Renderer.h"
 #include "Image.h"
 #include "core/Engine.h"
+#include "utils/Log.h"
+#include "utils/MemoryTracker.h"
 #include "utils/Utils.h"
 #include "math/MathUtils.h"
 
@@ -19,6 +21,8 @@ namespace ouzel
 
         TextureResource::~TextureResource()
         {
+            MemoryTracker::update(MemoryTracker::Tag::GRAPHICS, cpuMemorySize, 0);
+            MemoryTracker::update(MemoryTracker::Tag::GPU, gpuMemorySize, 0);
         }
 
         bool TextureResource::init(const Size2& newSize, bool newDynamic, bool newMipmaps, bool newRenderTarget, uint32_t newSampleCount, bool newDepth)
@@ -30,6 +34,7 @@ namespace ouzel
             pendingData.renderTarget = newRenderTarget;
             pendingData.sampleCount = newSampleCount;
             pendingData.depth = newDepth;
+            sourceFilename.clear();
 
             if (!calculateSizes(newSize))
             {
@@ -50,6 +55,7 @@ namespace ouzel
             pendingData.renderTarget = false;
             pendingData.sampleCount = 1;
             pendingData.depth = false;
+            sourceFilename.clear();
 
             if (!calculateData(newData, newSize))
             {
@@ -104,11 +110,26 @@ namespace ouzel
                 return false;
             }
 
+            sourceFilename.clear();
             pendingData.dirty |= 0x01;
 
             return true;
         }
 
+        void TextureResource::setSourceFilename(const std::string& newSourceFilename)
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            sourceFilename = newSourceFilename;
+        }
+
+        void TextureResource::setResidency(Residency newResidency)
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            residency = newResidency;
+        }
+
         bool TextureResource::calculateSizes(const Size2& newSize)
         {
             pendingData.levels.clear();
@@ -170,6 +191,8 @@ namespace ouzel
                 }
             }
 
+            updateMemoryUsage();
+
             return true;
         }
 
@@ -334,6 +357,8 @@ namespace ouzel
                 }
             }
 
+            updateMemoryUsage();
+
             return true;
         }
 
@@ -377,13 +402,114 @@ namespace ouzel
                 data.renderTarget = pendingData.renderTarget;
                 data.clearColorBuffer = pendingData.clearColorBuffer;
                 data.clearDepthBuffer = pendingData.clearDepthBuffer;
-                data.levels = std::move(pendingData.levels);
+                // only changing the size or the data creates new levels
+                if (!pendingData.levels.empty())
+                {
+                    data.levels = std::move(pendingData.levels);
+                    pendingData.levels.clear();
+                    dataReleased = false;
+                }
+
                 data.sampleCount = pendingData.sampleCount;
                 data.depth = pendingData.depth;
                 data.clearColor = pendingData.clearColor;
+
+                updateMemoryUsage();
             }
 
             return true;
         }
+
+        void TextureResource::releaseData()
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            if (residency == Residency::KEEP ||
+                (residency == Residency::DEFAULT && data.dynamic))
+            {
+                return;
+            }
+
+            // sizes of the levels are still needed by the backend
+            for (Level& level : data.levels)
+            {
+                if (!level.data.empty())
+                {
+                    std::vector<uint8_t>().swap(level.data);
+                    dataReleased = true;
+                }
+            }
+
+            updateMemoryUsage();
+        }
+
+        bool TextureResource::reload()
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+
+            // newer data that has not been uploaded yet is uploaded anyway
+            if (pendingData.levels.empty())
+            {
+                if (dataReleased)
+                {
+                    if (sourceFilename.empty())
+                    {
+                        Log(Log::Level::ERR) << "Failed to reload texture, its data was released and it has no source file";
+                        return false;
+                    }
+
+                    Image image;
+                    if (!image.initFromFile(sourceFilename))
+                    {
+                        return false;
+                    }
+
+                    if (!calculateData(image.getData(), image.getSize()))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    pendingData.levels = data.levels;
+                    updateMemoryUsage();
+                }
+            }
+
+            pendingData.dirty |= 0x01;
+
+            return true;
+        }
+
+        void TextureResource::updateMemoryUsage()
+        {
+            size_t newCpuMemorySize = 0;
+
+            for (const Level& level : data.levels)
+            {
+                newCpuMemorySize += level.data.capacity();
+            }
+
+            for (const Level& level : pendingData.levels)
+            {
+                newCpuMemorySize += level.data.capacity();
+            }
+
+            // RGBA8 for every level and sample, plus a 32-bit depth buffer
+            size_t newGpuMemorySize = 0;
+
+            for (const Level& level : data.levels)
+            {
+                newGpuMemorySize += static_cast<size_t>(level.size.v[0]) * static_cast<size_t>(level.size.v[1]) * 4 * data.sampleCount;
+            }
+
+            if (data.depth && !data.levels.empty())
+            {
+                newGpuMemorySize += static_cast<size_t>(data.size.v[0]) * static_cast<size_t>(data.size.v[1]) * 4 * data.sampleCount;
+            }
+
+            MemoryTracker::update(MemoryTracker::Tag::GRAPHICS, cpuMemorySize, newCpuMemorySize);
+            MemoryTracker::update(MemoryTracker::Tag::GPU, gpuMemorySize, newGpuMemorySize);
+        }
     } // namespace graphics
 } // namespace ouzel
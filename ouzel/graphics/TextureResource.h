@@ -31,6 +31,10 @@ namespace ouzel
             virtual bool setSize(const Size2& newSize);
             virtual bool setData(const std::vector<uint8_t>& newData, const Size2& newSize);
 
+            // file the data is loaded from again if it has been released when the context is lost
+            void setSourceFilename(const std::string& newSourceFilename);
+            void setResidency(Residency newResidency);
+
             bool getClearColorBuffer() const { return data.clearColorBuffer; }
             virtual void setClearColorBuffer(bool clear);
 
@@ -47,9 +51,12 @@ namespace ouzel
         protected:
             TextureResource();
             virtual bool upload() override;
+            virtual void releaseData() override;
+            virtual bool reload() override;
 
             bool calculateSizes(const Size2& newSize);
             bool calculateData(const std::vector<uint8_t>& newData, const Size2& newSize);
+            void updateMemoryUsage();
 
             struct Level
             {
@@ -79,6 +86,13 @@ namespace ouzel
 
             uint32_t frameBufferClearedFrame = 0;
 
+            std::string sourceFilename;
+            Residency residency = Residency::DEFAULT;
+            bool dataReleased = false;
+
+            size_t cpuMemorySize = 0;
+            size_t gpuMemorySize = 0;
+
         private:
             Data pendingData;
         };
@@ -600,7 +600,7 @@ namespace ouzel
                 // pixel shader constants
                 const std::vector<ShaderD3D11::Location>& pixelShaderConstantLocations = shaderD3D11->getPixelShaderConstantLocations();
 
-                if (drawCommand.pixelShaderConstants.size() > pixelShaderConstantLocations.size())
+                if (drawCommand.pixelShaderConstantCount > pixelShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                     return false;
@@ -608,18 +608,19 @@ namespace ouzel
 
                 shaderData.clear();
 
-                for (size_t i = 0; i < drawCommand.pixelShaderConstants.size(); ++i)
+                for (size_t i = 0; i < drawCommand.pixelShaderConstantCount; ++i)
                 {
                     const ShaderD3D11::Location& pixelShaderConstantLocation = pixelShaderConstantLocations[i];
-                    const std::vector<float>& pixelShaderConstant = drawCommand.pixelShaderConstants[i];
+                    const ShaderConstant& pixelShaderConstant = shaderConstants[drawCommand.firstPixelShaderConstant + i];
+                    const float* pixelShaderConstantData = shaderConstantData.data() + pixelShaderConstant.offset;
 
-                    if (sizeof(float) * pixelShaderConstant.size() != pixelShaderConstantLocation.size)
+                    if (sizeof(float) * pixelShaderConstant.size != pixelShaderConstantLocation.size)
                     {
                         Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                         return false;
                     }
 
-                    shaderData.insert(shaderData.end(), pixelShaderConstant.begin(), pixelShaderConstant.end());
+                    shaderData.insert(shaderData.end(), pixelShaderConstantData, pixelShaderConstantData + pixelShaderConstant.size);
                 }
 
                 shaderD3D11->uploadBuffer(shaderD3D11->getPixelShaderConstantBuffer(),
@@ -632,7 +633,7 @@ namespace ouzel
                 // vertex shader constants
                 const std::vector<ShaderD3D11::Location>& vertexShaderConstantLocations = shaderD3D11->getVertexShaderConstantLocations();
 
-                if (drawCommand.vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                if (drawCommand.vertexShaderConstantCount > vertexShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid vertex shader constant size";
                     return false;
@@ -640,18 +641,19 @@ namespace ouzel
 
                 shaderData.clear();
 
-                for (size_t i = 0; i < drawCommand.vertexShaderConstants.size(); ++i)
+                for (size_t i = 0; i < drawCommand.vertexShaderConstantCount; ++i)
                 {
                     const ShaderD3D11::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                    const std::vector<float>& vertexShaderConstant = drawCommand.vertexShaderConstants[i];
+                    const ShaderConstant& vertexShaderConstant = shaderConstants[drawCommand.firstVertexShaderConstant + i];
+                    const float* vertexShaderConstantData = shaderConstantData.data() + vertexShaderConstant.offset;
 
-                    if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
+                    if (sizeof(float) * vertexShaderConstant.size != vertexShaderConstantLocation.size)
                     {
                         Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                         return false;
                     }
 
-                    shaderData.insert(shaderData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
+                    shaderData.insert(shaderData.end(), vertexShaderConstantData, vertexShaderConstantData + vertexShaderConstant.size);
                 }
 
                 shaderD3D11->uploadBuffer(shaderD3D11->getVertexShaderConstantBuffer(),
@@ -675,12 +677,7 @@ namespace ouzel
                 // textures
                 for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
                 {
-                    TextureD3D11* textureD3D11 = nullptr;
-
-                    if (drawCommand.textures.size() > layer)
-                    {
-                        textureD3D11 = static_cast<TextureD3D11*>(drawCommand.textures[layer]);
-                    }
+                    TextureD3D11* textureD3D11 = static_cast<TextureD3D11*>(drawCommand.textures[layer]);
 
                     if (textureD3D11)
                     {
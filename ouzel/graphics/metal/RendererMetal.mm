@@ -569,7 +569,7 @@ namespace ouzel
                 // pixel shader constants
                 const std::vector<ShaderMetal::Location>& pixelShaderConstantLocations = shaderMetal->getPixelShaderConstantLocations();
 
-                if (drawCommand.pixelShaderConstants.size() > pixelShaderConstantLocations.size())
+                if (drawCommand.pixelShaderConstantCount > pixelShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                     return false;
@@ -577,18 +577,19 @@ namespace ouzel
 
                 shaderData.clear();
 
-                for (size_t i = 0; i < drawCommand.pixelShaderConstants.size(); ++i)
+                for (size_t i = 0; i < drawCommand.pixelShaderConstantCount; ++i)
                 {
                     const ShaderMetal::Location& pixelShaderConstantLocation = pixelShaderConstantLocations[i];
-                    const std::vector<float>& pixelShaderConstant = drawCommand.pixelShaderConstants[i];
+                    const ShaderConstant& pixelShaderConstant = shaderConstants[drawCommand.firstPixelShaderConstant + i];
+                    const float* pixelShaderConstantData = shaderConstantData.data() + pixelShaderConstant.offset;
 
-                    if (sizeof(float) * pixelShaderConstant.size() != pixelShaderConstantLocation.size)
+                    if (sizeof(float) * pixelShaderConstant.size != pixelShaderConstantLocation.size)
                     {
                         Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                         return false;
                     }
 
-                    shaderData.insert(shaderData.end(), pixelShaderConstant.begin(), pixelShaderConstant.end());
+                    shaderData.insert(shaderData.end(), pixelShaderConstantData, pixelShaderConstantData + pixelShaderConstant.size);
                 }
 
                 shaderMetal->uploadBuffer(shaderMetal->getPixelShaderConstantBuffer(),
@@ -603,7 +604,7 @@ namespace ouzel
                 // vertex shader constants
                 const std::vector<ShaderMetal::Location>& vertexShaderConstantLocations = shaderMetal->getVertexShaderConstantLocations();
 
-                if (drawCommand.vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                if (drawCommand.vertexShaderConstantCount > vertexShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid vertex shader constant size";
                     return false;
@@ -611,18 +612,19 @@ namespace ouzel
 
                 shaderData.clear();
 
-                for (size_t i = 0; i < drawCommand.vertexShaderConstants.size(); ++i)
+                for (size_t i = 0; i < drawCommand.vertexShaderConstantCount; ++i)
                 {
                     const ShaderMetal::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                    const std::vector<float>& vertexShaderConstant = drawCommand.vertexShaderConstants[i];
+                    const ShaderConstant& vertexShaderConstant = shaderConstants[drawCommand.firstVertexShaderConstant + i];
+                    const float* vertexShaderConstantData = shaderConstantData.data() + vertexShaderConstant.offset;
 
-                    if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
+                    if (sizeof(float) * vertexShaderConstant.size != vertexShaderConstantLocation.size)
                     {
                         Log(Log::Level::ERR) << "Invalid vertex shader constant size";
                         return false;
                     }
 
-                    shaderData.insert(shaderData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
+                    shaderData.insert(shaderData.end(), vertexShaderConstantData, vertexShaderConstantData + vertexShaderConstant.size);
                 }
 
                 shaderMetal->uploadBuffer(shaderMetal->getVertexShaderConstantBuffer(),
@@ -668,12 +670,7 @@ namespace ouzel
                 // textures
                 for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
                 {
-                    TextureMetal* textureMetal = nullptr;
-
-                    if (drawCommand.textures.size() > layer)
-                    {
-                        textureMetal = static_cast<TextureMetal*>(drawCommand.textures[layer]);
-                    }
+                    TextureMetal* textureMetal = static_cast<TextureMetal*>(drawCommand.textures[layer]);
 
                     if (textureMetal)
                     {
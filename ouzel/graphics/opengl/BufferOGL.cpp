@@ -151,5 +151,14 @@ namespace ouzel
 
             return true;
         }
+
+        bool BufferOGL::reload()
+        {
+            // the buffer was deleted with the context
+            bufferId = 0;
+            bufferSize = 0;
+
+            return BufferResource::reload();
+        }
     } // namespace graphics
 } // namespace ouzel
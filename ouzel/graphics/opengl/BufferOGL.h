@@ -38,6 +38,7 @@ namespace ouzel
         protected:
             bool bindBuffer();
             virtual bool upload() override;
+            virtual bool reload() override;
 
             GLuint bufferId = 0;
             GLsizeiptr bufferSize = 0;
@@ -233,5 +233,13 @@ namespace ouzel
 
             return true;
         }
+
+        bool MeshBufferOGL::reload()
+        {
+            // the vertex array was deleted with the context
+            vertexArrayId = 0;
+
+            return MeshBufferResource::reload();
+        }
     } // namespace graphics
 } // namespace ouzel
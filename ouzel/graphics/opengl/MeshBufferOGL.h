@@ -38,6 +38,7 @@ namespace ouzel
 
         protected:
             virtual bool upload() override;
+            virtual bool reload() override;
 
             GLenum indexType = 0;
             GLuint bytesPerIndex = 0;
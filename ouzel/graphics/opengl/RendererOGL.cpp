@@ -340,6 +340,7 @@ namespace ouzel
             sharedEngine->getCache()->setBlendState(BLEND_ALPHA, alphaBlendState);
 
             std::shared_ptr<Texture> whitePixelTexture = std::make_shared<Texture>();
+            whitePixelTexture->setResidency(Residency::KEEP);
             whitePixelTexture->initFromBuffer({255, 255, 255, 255}, Size2(1.0f, 1.0f), false, false);
             sharedEngine->getCache()->setTexture(TEXTURE_WHITE_PIXEL, whitePixelTexture);
 
@@ -400,6 +401,21 @@ namespace ouzel
             return true;
         }
 
+        bool RendererOGL::reloadResources()
+        {
+            // the frame buffer is created again by the next update and nothing is bound in the new context
+#if !OUZEL_OPENGL_INTERFACE_EGL
+            frameBufferId = 0;
+            colorRenderBufferId = 0;
+            depthRenderBufferId = 0;
+#endif
+            frameBufferWidth = 0;
+            frameBufferHeight = 0;
+            stateCache = StateCache();
+
+            return Renderer::reloadResources();
+        }
+
         bool RendererOGL::process()
         {
             if (!lockContext())
@@ -483,12 +499,7 @@ namespace ouzel
                 // textures
                 for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
                 {
-                    TextureOGL* textureOGL = nullptr;
-
-                    if (drawCommand.textures.size() > layer)
-                    {
-                        textureOGL = static_cast<TextureOGL*>(drawCommand.textures[layer]);
-                    }
+                    TextureOGL* textureOGL = static_cast<TextureOGL*>(drawCommand.textures[layer]);
 
                     if (textureOGL)
                     {
@@ -525,36 +536,37 @@ namespace ouzel
                 // pixel shader constants
                 const std::vector<ShaderOGL::Location>& pixelShaderConstantLocations = shaderOGL->getPixelShaderConstantLocations();
 
-                if (drawCommand.pixelShaderConstants.size() > pixelShaderConstantLocations.size())
+                if (drawCommand.pixelShaderConstantCount > pixelShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                     return false;
                 }
 
-                for (size_t i = 0; i < drawCommand.pixelShaderConstants.size(); ++i)
+                for (size_t i = 0; i < drawCommand.pixelShaderConstantCount; ++i)
                 {
                     const ShaderOGL::Location& pixelShaderConstantLocation = pixelShaderConstantLocations[i];
-                    const std::vector<float>& pixelShaderConstant = drawCommand.pixelShaderConstants[i];
+                    const ShaderConstant& pixelShaderConstant = shaderConstants[drawCommand.firstPixelShaderConstant + i];
+                    const float* pixelShaderConstantData = shaderConstantData.data() + pixelShaderConstant.offset;
 
                     switch (pixelShaderConstantLocation.dataType)
                     {
                         case Shader::DataType::FLOAT:
-                            glUniform1fv(pixelShaderConstantLocation.location, 1, pixelShaderConstant.data());
+                            glUniform1fv(pixelShaderConstantLocation.location, 1, pixelShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_VECTOR2:
-                            glUniform2fv(pixelShaderConstantLocation.location, 1, pixelShaderConstant.data());
+                            glUniform2fv(pixelShaderConstantLocation.location, 1, pixelShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_VECTOR3:
-                            glUniform3fv(pixelShaderConstantLocation.location, 1, pixelShaderConstant.data());
+                            glUniform3fv(pixelShaderConstantLocation.location, 1, pixelShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_VECTOR4:
-                            glUniform4fv(pixelShaderConstantLocation.location, 1, pixelShaderConstant.data());
+                            glUniform4fv(pixelShaderConstantLocation.location, 1, pixelShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_MATRIX3:
-                            glUniformMatrix3fv(pixelShaderConstantLocation.location, 1, GL_FALSE, pixelShaderConstant.data());
+                            glUniformMatrix3fv(pixelShaderConstantLocation.location, 1, GL_FALSE, pixelShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_MATRIX4:
-                            glUniformMatrix4fv(pixelShaderConstantLocation.location, 1, GL_FALSE, pixelShaderConstant.data());
+                            glUniformMatrix4fv(pixelShaderConstantLocation.location, 1, GL_FALSE, pixelShaderConstantData);
                             break;
                         default:
                             Log(Log::Level::ERR) << "Unsupported uniform size";
@@ -565,36 +577,37 @@ namespace ouzel
                 // vertex shader constants
                 const std::vector<ShaderOGL::Location>& vertexShaderConstantLocations = shaderOGL->getVertexShaderConstantLocations();
 
-                if (drawCommand.vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                if (drawCommand.vertexShaderConstantCount > vertexShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid vertex shader constant size";
                     return false;
                 }
 
-                for (size_t i = 0; i < drawCommand.vertexShaderConstants.size(); ++i)
+                for (size_t i = 0; i < drawCommand.vertexShaderConstantCount; ++i)
                 {
                     const ShaderOGL::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                    const std::vector<float>& vertexShaderConstant = drawCommand.vertexShaderConstants[i];
+                    const ShaderConstant& vertexShaderConstant = shaderConstants[drawCommand.firstVertexShaderConstant + i];
+                    const float* vertexShaderConstantData = shaderConstantData.data() + vertexShaderConstant.offset;
 
                     switch (vertexShaderConstantLocation.dataType)
                     {
                         case Shader::DataType::FLOAT:
-                            glUniform1fv(vertexShaderConstantLocation.location, 1, vertexShaderConstant.data());
+                            glUniform1fv(vertexShaderConstantLocation.location, 1, vertexShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_VECTOR2:
-                            glUniform2fv(vertexShaderConstantLocation.location, 1, vertexShaderConstant.data());
+                            glUniform2fv(vertexShaderConstantLocation.location, 1, vertexShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_VECTOR3:
-                            glUniform3fv(vertexShaderConstantLocation.location, 1, vertexShaderConstant.data());
+                            glUniform3fv(vertexShaderConstantLocation.location, 1, vertexShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_VECTOR4:
-                            glUniform4fv(vertexShaderConstantLocation.location, 1, vertexShaderConstant.data());
+                            glUniform4fv(vertexShaderConstantLocation.location, 1, vertexShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_MATRIX3:
-                            glUniformMatrix3fv(vertexShaderConstantLocation.location, 1, GL_FALSE, vertexShaderConstant.data());
+                            glUniformMatrix3fv(vertexShaderConstantLocation.location, 1, GL_FALSE, vertexShaderConstantData);
                             break;
                         case Shader::DataType::FLOAT_MATRIX4:
-                            glUniformMatrix4fv(vertexShaderConstantLocation.location, 1, GL_FALSE, vertexShaderConstant.data());
+                            glUniformMatrix4fv(vertexShaderConstantLocation.location, 1, GL_FALSE, vertexShaderConstantData);
                             break;
                         default:
                             Log(Log::Level::ERR) << "Unsupported uniform size";
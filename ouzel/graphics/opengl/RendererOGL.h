@@ -67,6 +67,7 @@ namespace ouzel
             virtual ShaderResource* createShader() override;
             virtual MeshBufferResource* createMeshBuffer() override;
             virtual BufferResource* createBuffer() override;
+            virtual bool reloadResources() override;
 
             static inline bool checkOpenGLError(bool logError = true)
             {
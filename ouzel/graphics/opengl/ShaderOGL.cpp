@@ -240,5 +240,15 @@ namespace ouzel
 
             return true;
         }
+
+        bool ShaderOGL::reload()
+        {
+            // the program and the shaders were deleted with the context
+            programId = 0;
+            vertexShaderId = 0;
+            pixelShaderId = 0;
+
+            return ShaderResource::reload();
+        }
     } // namespace graphics
 } // namespace ouzel
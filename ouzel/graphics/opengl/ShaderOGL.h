@@ -42,6 +42,7 @@ namespace ouzel
 
         protected:
             virtual bool upload() override;
+            virtual bool reload() override;
 
             void printShaderMessage(GLuint shaderId);
             void printProgramMessage();
@@ -188,5 +188,17 @@ namespace ouzel
 
             return true;
         }
+
+        bool TextureOGL::reload()
+        {
+            // the objects were deleted with the context
+            textureId = 0;
+            frameBufferId = 0;
+            depthBufferId = 0;
+            width = 0;
+            height = 0;
+
+            return TextureResource::reload();
+        }
     } // namespace graphics
 } // namespace ouzel
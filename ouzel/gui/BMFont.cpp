@@ -177,6 +177,14 @@ namespace ouzel
         return true;
     }
 
+    size_t BMFont::getMemorySize() const
+    {
+        // hash nodes hold a next pointer, tree nodes three pointers and a color
+        return chars.size() * (sizeof(std::pair<const uint32_t, CharDescriptor>) + sizeof(void*)) +
+            chars.bucket_count() * sizeof(void*) +
+            kern.size() * (sizeof(std::pair<const std::pair<uint32_t, uint32_t>, int16_t>) + 4 * sizeof(void*));
+    }
+
     int16_t BMFont::getKerningPair(uint32_t first, uint32_t second)
     {
         auto i = kern.find(std::make_pair(first, second));
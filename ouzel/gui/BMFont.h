@@ -38,6 +38,9 @@ namespace ouzel
 
         const std::string& getTexture() const { return texture; }
 
+        // estimated size of the glyph and kerning tables
+        size_t getMemorySize() const;
+
     protected:
         bool parseFont(const std::string& filename);
         int16_t getKerningPair(uint32_t, uint32_t);
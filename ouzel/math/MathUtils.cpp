@@ -1,8 +1,141 @@
 // Copyright (C) 2017 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE2
+#include <emmintrin.h>
+#endif
 #include "MathUtils.h"
+#include "utils/Utils.h"
 
 namespace ouzel
 {
+    // Cody-Waite split of pi/2, the first two parts have few enough bits to be multiplied exactly
+    static const float PI_2_A = 1.5703125f;
+    static const float PI_2_B = 4.837512969970703125e-4f;
+    static const float PI_2_C = 7.54978995489188216e-8f;
+    static const float TWO_OVER_PI = 0.63661977236758134f;
+
+    static const float SIN_C1 = -1.6666654611e-1f;
+    static const float SIN_C2 = 8.3321608736e-3f;
+    static const float SIN_C3 = -1.9515295891e-4f;
+
+    static const float COS_C1 = 4.166664568298827e-2f;
+    static const float COS_C2 = -1.388731625493765e-3f;
+    static const float COS_C3 = 2.443315711809948e-5f;
+
+    void sinCos(const float* angles, float* sines, float* cosines, uint32_t count)
+    {
+        uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+        if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+        {
+            float32x4_t half = vdupq_n_f32(0.5f);
+            uint32x4_t signMask = vdupq_n_u32(0x80000000);
+            int32x4_t one = vdupq_n_s32(1);
+            int32x4_t two = vdupq_n_s32(2);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                float32x4_t x = vld1q_f32(angles + i);
+
+                // quadrant, rounded half away from zero
+                float32x4_t v = vmulq_n_f32(x, TWO_OVER_PI);
+                float32x4_t rounding = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(v), signMask), vreinterpretq_u32_f32(half)));
+                int32x4_t j = vcvtq_s32_f32(vaddq_f32(v, rounding));
+                float32x4_t fj = vcvtq_f32_s32(j);
+
+                float32x4_t y = vmlsq_n_f32(x, fj, PI_2_A);
+                y = vmlsq_n_f32(y, fj, PI_2_B);
+                y = vmlsq_n_f32(y, fj, PI_2_C);
+                float32x4_t y2 = vmulq_f32(y, y);
+
+                float32x4_t s = vmlaq_n_f32(vdupq_n_f32(SIN_C2), y2, SIN_C3);
+                s = vmlaq_f32(vdupq_n_f32(SIN_C1), s, y2);
+                s = vmlaq_f32(y, vmulq_f32(s, y2), y);
+
+                float32x4_t c = vmlaq_n_f32(vdupq_n_f32(COS_C2), y2, COS_C3);
+                c = vmlaq_f32(vdupq_n_f32(COS_C1), c, y2);
+                c = vmlaq_f32(vmlsq_f32(vdupq_n_f32(1.0f), y2, half), vmulq_f32(c, y2), y2);
+
+                uint32x4_t swap = vceqq_s32(vandq_s32(j, one), one);
+                uint32x4_t sinSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(j, two)), 30);
+                uint32x4_t cosSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(vaddq_s32(j, one), two)), 30);
+
+                float32x4_t sine = vbslq_f32(swap, c, s);
+                float32x4_t cosine = vbslq_f32(swap, s, c);
+
+                vst1q_f32(sines + i, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sine), sinSign)));
+                vst1q_f32(cosines + i, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cosine), cosSign)));
+            }
+        }
+#elif OUZEL_SUPPORTS_SSE2
+        __m128 half = _mm_set1_ps(0.5f);
+        __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+        __m128i one = _mm_set1_epi32(1);
+        __m128i two = _mm_set1_epi32(2);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(angles + i);
+
+            // quadrant, rounded half away from zero
+            __m128 v = _mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI));
+            __m128 rounding = _mm_or_ps(_mm_and_ps(v, signMask), half);
+            __m128i j = _mm_cvttps_epi32(_mm_add_ps(v, rounding));
+            __m128 fj = _mm_cvtepi32_ps(j);
+
+            __m128 y = _mm_sub_ps(x, _mm_mul_ps(fj, _mm_set1_ps(PI_2_A)));
+            y = _mm_sub_ps(y, _mm_mul_ps(fj, _mm_set1_ps(PI_2_B)));
+            y = _mm_sub_ps(y, _mm_mul_ps(fj, _mm_set1_ps(PI_2_C)));
+            __m128 y2 = _mm_mul_ps(y, y);
+
+            __m128 s = _mm_add_ps(_mm_mul_ps(y2, _mm_set1_ps(SIN_C3)), _mm_set1_ps(SIN_C2));
+            s = _mm_add_ps(_mm_mul_ps(s, y2), _mm_set1_ps(SIN_C1));
+            s = _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(s, y2), y));
+
+            __m128 c = _mm_add_ps(_mm_mul_ps(y2, _mm_set1_ps(COS_C3)), _mm_set1_ps(COS_C2));
+            c = _mm_add_ps(_mm_mul_ps(c, y2), _mm_set1_ps(COS_C1));
+            c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(y2, half)), _mm_mul_ps(_mm_mul_ps(c, y2), y2));
+
+            __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, one), one));
+            __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, two), 30));
+            __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, one), two), 30));
+
+            __m128 sine = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+            __m128 cosine = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+            _mm_storeu_ps(sines + i, _mm_xor_ps(sine, sinSign));
+            _mm_storeu_ps(cosines + i, _mm_xor_ps(cosine, cosSign));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            float x = angles[i];
+
+            float v = x * TWO_OVER_PI;
+            int32_t j = static_cast<int32_t>(v + (v < 0.0f ? -0.5f : 0.5f));
+            float fj = static_cast<float>(j);
+
+            float y = x - fj * PI_2_A;
+            y = y - fj * PI_2_B;
+            y = y - fj * PI_2_C;
+            float y2 = y * y;
+
+            float s = y + ((SIN_C3 * y2 + SIN_C2) * y2 + SIN_C1) * y2 * y;
+            float c = 1.0f - 0.5f * y2 + ((COS_C3 * y2 + COS_C2) * y2 + COS_C1) * y2 * y2;
+
+            float sine = (j & 1) ? c : s;
+            float cosine = (j & 1) ? s : c;
+
+            sines[i] = (j & 2) ? -sine : sine;
+            cosines[i] = ((j + 1) & 2) ? -cosine : cosine;
+        }
+    }
 }
@@ -84,4 +84,7 @@ namespace ouzel
         }
         return hash;
     }
+
+    // calculates sines and cosines of count angles (in radians), accurate to about 1e-7 for angles up to a few thousand radians
+    void sinCos(const float* angles, float* sines, float* cosines, uint32_t count);
 }
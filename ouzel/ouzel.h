@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include "animators/AnimationClip.h"
+#include "animators/AnimationManager.h"
 #include "animators/Animator.h"
+#include "animators/ClipAnimator.h"
 #include "animators/Ease.h"
 #include "animators/Fade.h"
 #include "animators/Move.h"
@@ -20,12 +23,16 @@
 #include "core/Cache.h"
 #include "core/CompileConfig.h"
 #include "core/Engine.h"
+#include "core/FrameAllocator.h"
+#include "core/FramePacer.h"
+#include "core/JobSystem.h"
 #include "core/Settings.h"
 #include "core/UpdateCallback.h"
 #include "core/Window.h"
 #include "events/Event.h"
 #include "events/EventDispatcher.h"
 #include "events/EventHandler.h"
+#include "events/EventQueue.h"
 #include "files/FileSystem.h"
 #include "graphics/BlendStateResource.h"
 #include "graphics/Image.h"
@@ -67,15 +74,24 @@
 #include "math/Vector4.h"
 #include "scene/Camera.h"
 #include "scene/Component.h"
+#include "scene/EntityStore.h"
 #include "scene/Layer.h"
+#include "scene/LevelOfDetail.h"
 #include "scene/Node.h"
+#include "scene/ParticleManager.h"
 #include "scene/ParticleSystem.h"
 #include "scene/Scene.h"
 #include "scene/SceneManager.h"
 #include "scene/ShapeDrawable.h"
+#include "scene/Skeleton.h"
+#include "scene/SkinnedMesh.h"
 #include "scene/Sprite.h"
+#include "scene/StaticBatch.h"
 #include "scene/TextDrawable.h"
 #include "utils/Log.h"
+#include "utils/MemoryTracker.h"
 #include "utils/OBF.h"
+#include "utils/ObjectPool.h"
+#include "utils/Random.h"
 #include "utils/Types.h"
 #include "utils/Utils.h"
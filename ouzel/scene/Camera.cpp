@@ -171,6 +171,46 @@ namespace ouzel
                 return true;
             }
 
+            Vector4 clipPos;
+            Size2 halfWorldSize;
+            projectBoundingBox(boxTransform, boundingBox, clipPos, halfWorldSize);
+
+            assert(clipPos.v[3] != 0.0f);
+
+            // normalize position of the center point
+            Vector2 v2p((clipPos.v[0] / clipPos.v[3] + 1.0f) * 0.5f,
+                        (clipPos.v[1] / clipPos.v[3] + 1.0f) * 0.5f);
+
+            // create visible rect in clip space
+            Rectangle visibleRect(-halfWorldSize.v[0],
+                                  -halfWorldSize.v[1],
+                                  1.0f + halfWorldSize.v[0] * 2.0f,
+                                  1.0f + halfWorldSize.v[1] * 2.0f);
+
+            return visibleRect.containsPoint(v2p);
+        }
+
+        Size2 Camera::getScreenSize(const Matrix4& boxTransform, const AABB3& boundingBox) const
+        {
+            Vector4 clipPos;
+            Size2 halfWorldSize;
+            projectBoundingBox(boxTransform, boundingBox, clipPos, halfWorldSize);
+
+            float w = fabsf(clipPos.v[3]);
+
+            if (w == 0.0f)
+            {
+                return Size2();
+            }
+
+            // clip space spans two units, so the half size in clip space is the full size in viewport units
+            return Size2(halfWorldSize.v[0] * renderViewport.size.v[0] / w,
+                         halfWorldSize.v[1] * renderViewport.size.v[1] / w);
+        }
+
+        void Camera::projectBoundingBox(const Matrix4& boxTransform, const AABB3& boundingBox,
+                                        Vector4& clipPos, Size2& halfWorldSize) const
+        {
             // calculate center point of the bounding box
             Vector2 diff = boundingBox.max - boundingBox.min;
 
@@ -181,37 +221,20 @@ namespace ouzel
             boxTransform.transformPoint(v3p);
 
             // tranform the center to viewport's clip space
-            Vector4 clipPos;
             getViewProjection().transformVector(Vector4(v3p.v[0], v3p.v[1], v3p.v[2], 1.0f), clipPos);
 
-            assert(clipPos.v[3] != 0.0f);
-
-            // normalize position of the center point
-            Vector2 v2p((clipPos.v[0] / clipPos.v[3] + 1.0f) * 0.5f,
-                        (clipPos.v[1] / clipPos.v[3] + 1.0f) * 0.5f);
-
             // calculate half size
             Size2 halfSize(diff.v[0] / 2.0f, diff.v[1] / 2.0f);
 
             // convert content size to world coordinates
-            Size2 halfWorldSize;
-
             halfWorldSize.v[0] = std::max(fabsf(halfSize.v[0] * boxTransform.m[0] + halfSize.v[1] * boxTransform.m[4]),
-                                           fabsf(halfSize.v[0] * boxTransform.m[0] - halfSize.v[1] * boxTransform.m[4]));
+                                          fabsf(halfSize.v[0] * boxTransform.m[0] - halfSize.v[1] * boxTransform.m[4]));
             halfWorldSize.v[1] = std::max(fabsf(halfSize.v[0] * boxTransform.m[1] + halfSize.v[1] * boxTransform.m[5]),
-                                            fabsf(halfSize.v[0] * boxTransform.m[1] - halfSize.v[1] * boxTransform.m[5]));
+                                          fabsf(halfSize.v[0] * boxTransform.m[1] - halfSize.v[1] * boxTransform.m[5]));
 
             // scale half size by camera projection to get the size in clip space coordinates
             halfWorldSize.v[0] *= (fabsf(viewProjection.m[0]) + fabsf(viewProjection.m[4])) / 2.0f;
             halfWorldSize.v[1] *= (fabsf(viewProjection.m[1]) + fabsf(viewProjection.m[5])) / 2.0f;
-
-            // create visible rect in clip space
-            Rectangle visibleRect(-halfWorldSize.v[0],
-                                  -halfWorldSize.v[1],
-                                  1.0f + halfWorldSize.v[0] * 2.0f,
-                                  1.0f + halfWorldSize.v[1] * 2.0f);
-
-            return visibleRect.containsPoint(v2p);
         }
 
         void Camera::setViewport(const Rectangle& newViewport)
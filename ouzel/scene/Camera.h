@@ -59,6 +59,7 @@ namespace ouzel
             Vector2 convertWorldToNormalized(const Vector3& position) const;
 
             bool checkVisibility(const Matrix4& boxTransform, const AABB3& boundingBox) const;
+            Size2 getScreenSize(const Matrix4& boxTransform, const AABB3& boundingBox) const;
 
             void setViewport(const Rectangle& newViewport);
             const Rectangle& getViewport() const { return viewport; }
@@ -88,6 +89,8 @@ namespace ouzel
         protected:
             virtual void calculateTransform() const override;
             void calculateViewProjection() const;
+            void projectBoundingBox(const Matrix4& boxTransform, const AABB3& boundingBox,
+                                    Vector4& clipPos, Size2& halfWorldSize) const;
 
             Type type;
             float fov;
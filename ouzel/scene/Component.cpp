@@ -3,6 +3,7 @@
 
 #include "Component.h"
 #include "Node.h"
+#include "LevelOfDetail.h"
 #include "utils/Utils.h"
 #include "math/MathUtils.h"
 
@@ -13,6 +14,7 @@ namespace ouzel
         Component::~Component()
         {
             if (node) node->removeComponent(this);
+            if (levelOfDetail) levelOfDetail->removeLevel(this);
         }
 
         void Component::draw(const Matrix4&,
@@ -27,18 +29,40 @@ namespace ouzel
         {
         }
 
+        bool Component::bake(const Matrix4&,
+                             const Color&,
+                             StaticBatch&) const
+        {
+            return false;
+        }
+
+        void Component::setHidden(bool newHidden)
+        {
+            if (hidden != newHidden)
+            {
+                hidden = newHidden;
+                invalidateNode();
+            }
+        }
+
+        void Component::invalidateNode()
+        {
+            if (node) node->nodeChanged(node);
+            // levels are not added to a node, so the node of the level of detail is invalidated
+            else if (levelOfDetail) levelOfDetail->invalidateNode();
+        }
+
         bool Component::pointOn(const Vector2& position) const
         {
             return boundingBox.containsPoint(position);
         }
 
-        inline void gatherPolygonProjectionExtents(const std::vector<Vector2>& vertList,
+        inline void gatherPolygonProjectionExtents(const Vector2* vertList, size_t vertListSize,
                                                    const ouzel::Vector2& v,
                                                    float& outMin, float& outMax)
         {
             outMin = outMax = v.dot(vertList[0]);
 
-            size_t vertListSize = vertList.size();
             for (size_t i = 1 ; i < vertListSize; ++i)
             {
                 float d = v.dot(vertList[i]);
@@ -47,12 +71,11 @@ namespace ouzel
             }
         }
 
-        inline bool findSeparatingAxis(const std::vector<Vector2>& aVertList,
-                                       const std::vector<Vector2>& bVertList)
+        inline bool findSeparatingAxis(const Vector2* aVertList, size_t aVertListSize,
+                                       const Vector2* bVertList, size_t bVertListSize)
         {
             ouzel::Vector2 v;
 
-            size_t aVertListSize = aVertList.size();
             size_t prev = aVertListSize - 1;
             for (size_t cur = 0; cur < aVertListSize; ++cur)
             {
@@ -62,8 +85,8 @@ namespace ouzel
                 v.v[1] = -edge.v[0];
 
                 float aMin, aMax, bMin, bMax;
-                gatherPolygonProjectionExtents(aVertList, v, aMin, aMax);
-                gatherPolygonProjectionExtents(bVertList, v, bMin, bMax);
+                gatherPolygonProjectionExtents(aVertList, aVertListSize, v, aMin, aMax);
+                gatherPolygonProjectionExtents(bVertList, bVertListSize, v, bMin, bMax);
 
                 if (aMax < bMin) return true;
                 if (bMax < aMin) return true;
@@ -74,19 +97,21 @@ namespace ouzel
             return false;
         }
 
-        bool Component::shapeOverlaps(const std::vector<Vector2>& edges) const
+        bool Component::shapeOverlaps(const FrameVector<Vector2>& edges) const
         {
-            std::vector<Vector2> boundingBoxEdges = {
+            if (edges.empty()) return false;
+
+            Vector2 boundingBoxEdges[] = {
                 Vector2(boundingBox.min),
                 Vector2(boundingBox.max.v[0], boundingBox.min.v[1]),
                 Vector2(boundingBox.max),
                 Vector2(boundingBox.min.v[0], boundingBox.max.v[1])
             };
 
-            if (findSeparatingAxis(boundingBoxEdges, edges))
+            if (findSeparatingAxis(boundingBoxEdges, 4, edges.data(), edges.size()))
                 return false;
 
-            if (findSeparatingAxis(edges, boundingBoxEdges))
+            if (findSeparatingAxis(edges.data(), edges.size(), boundingBoxEdges, 4))
                 return false;
 
             return true;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <vector>
+#include "core/FrameAllocator.h"
 #include "utils/Noncopyable.h"
 #include "math/AABB3.h"
 #include "math/Matrix4.h"
@@ -14,11 +15,14 @@ namespace ouzel
     namespace scene
     {
         class Camera;
+        class LevelOfDetail;
         class Node;
+        class StaticBatch;
 
         class Component: public ouzel::Noncopyable
         {
             friend Node;
+            friend LevelOfDetail;
         public:
             virtual ~Component();
 
@@ -30,21 +34,28 @@ namespace ouzel
                                        const Color& drawColor,
                                        scene::Camera* camera);
 
-            virtual void setBoundingBox(const AABB3& newBoundingBox) { boundingBox = newBoundingBox; }
+            virtual bool bake(const Matrix4& transformMatrix,
+                              const Color& drawColor,
+                              StaticBatch& staticBatch) const;
+
+            virtual void setBoundingBox(const AABB3& newBoundingBox) { boundingBox = newBoundingBox; invalidateNode(); }
             virtual const AABB3& getBoundingBox() const { return boundingBox; }
             bool isAddedToNode() const { return node != nullptr; }
 
             virtual bool pointOn(const Vector2& position) const;
-            virtual bool shapeOverlaps(const std::vector<Vector2>& edges) const;
+            virtual bool shapeOverlaps(const FrameVector<Vector2>& edges) const;
 
             bool isHidden() const { return hidden; }
-            void setHidden(bool newHidden) { hidden = newHidden; }
+            void setHidden(bool newHidden);
 
         protected:
+            void invalidateNode();
+
             AABB3 boundingBox;
             bool hidden = false;
 
             Node* node = nullptr;
+            LevelOfDetail* levelOfDetail = nullptr;
         };
     } // namespace scene
 } // namespace ouzel
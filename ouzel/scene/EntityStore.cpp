@@ -0,0 +1,831 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <cmath>
+#include <limits>
+#include "EntityStore.h"
+#include "core/Engine.h"
+#include "core/Cache.h"
+#include "graphics/Renderer.h"
+#include "Camera.h"
+#include "math/MathUtils.h"
+#include "utils/Log.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static const uint32_t ENTITY_INDEX_BITS = 32;
+        static const uint32_t ENTITY_INDEX_MASK = 0xFFFFFFFF;
+        static const uint32_t INVALID_MESH_BATCH = 0xFFFFFFFF;
+        static const uint32_t MAX_BATCH_VERTICES = std::numeric_limits<uint16_t>::max() + 1;
+
+        void EntityStore::Archetype::pushBack(Entity entity)
+        {
+            entities.push_back(entity);
+
+            if (components & TRANSFORM)
+            {
+                positions.push_back(Vector2());
+                rotations.push_back(0.0f);
+                scales.push_back(Vector2(1.0f, 1.0f));
+            }
+
+            if (components & SPRITE)
+            {
+                frames.push_back(0);
+                colors.push_back(Color::WHITE);
+            }
+
+            if (components & VELOCITY)
+            {
+                velocities.push_back(Vector2());
+                angularVelocities.push_back(0.0f);
+            }
+        }
+
+        EntityStore::Entity EntityStore::Archetype::swapRemove(uint32_t row)
+        {
+            uint32_t last = static_cast<uint32_t>(entities.size() - 1);
+
+            entities[row] = entities[last];
+            entities.pop_back();
+
+            if (components & TRANSFORM)
+            {
+                positions[row] = positions[last];
+                positions.pop_back();
+                rotations[row] = rotations[last];
+                rotations.pop_back();
+                scales[row] = scales[last];
+                scales.pop_back();
+            }
+
+            if (components & SPRITE)
+            {
+                frames[row] = frames[last];
+                frames.pop_back();
+                colors[row] = colors[last];
+                colors.pop_back();
+            }
+
+            if (components & VELOCITY)
+            {
+                velocities[row] = velocities[last];
+                velocities.pop_back();
+                angularVelocities[row] = angularVelocities[last];
+                angularVelocities.pop_back();
+            }
+
+            // entity that was moved into the row
+            return row < last ? entities[row] : INVALID_ENTITY;
+        }
+
+        void EntityStore::Archetype::copy(uint32_t row, Archetype& destination, uint32_t destinationRow) const
+        {
+            uint32_t shared = components & destination.components;
+
+            if (shared & TRANSFORM)
+            {
+                destination.positions[destinationRow] = positions[row];
+                destination.rotations[destinationRow] = rotations[row];
+                destination.scales[destinationRow] = scales[row];
+            }
+
+            if (shared & SPRITE)
+            {
+                destination.frames[destinationRow] = frames[row];
+                destination.colors[destinationRow] = colors[row];
+            }
+
+            if (shared & VELOCITY)
+            {
+                destination.velocities[destinationRow] = velocities[row];
+                destination.angularVelocities[destinationRow] = angularVelocities[row];
+            }
+        }
+
+        EntityStore::EntityStore()
+        {
+            shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
+            whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
+
+            for (uint32_t i = 0; i < ARCHETYPE_COUNT; ++i)
+            {
+                archetypes[i].components = i;
+            }
+
+            updateCallback.callback = std::bind(&EntityStore::update, this, std::placeholders::_1);
+            sharedEngine->scheduleUpdate(&updateCallback);
+        }
+
+        EntityStore::~EntityStore()
+        {
+            sharedEngine->unscheduleUpdate(&updateCallback);
+        }
+
+        void EntityStore::update(float delta)
+        {
+            // movement system
+            for (uint32_t i = 0; i < ARCHETYPE_COUNT; ++i)
+            {
+                Archetype& archetype = archetypes[i];
+
+                if ((archetype.components & (TRANSFORM | VELOCITY)) == (TRANSFORM | VELOCITY) &&
+                    !archetype.entities.empty())
+                {
+                    uint32_t count = archetype.getSize();
+                    Vector2* positions = archetype.positions.data();
+                    float* rotations = archetype.rotations.data();
+                    const Vector2* velocities = archetype.velocities.data();
+                    const float* angularVelocities = archetype.angularVelocities.data();
+
+                    for (uint32_t row = 0; row < count; ++row)
+                    {
+                        positions[row].v[0] += velocities[row].v[0] * delta;
+                        positions[row].v[1] += velocities[row].v[1] * delta;
+                        rotations[row] += angularVelocities[row] * delta;
+                    }
+
+                    if (archetype.components & SPRITE)
+                    {
+                        archetypeMeshes[i].dirty = true;
+                        verticesDirty = true;
+                    }
+                }
+            }
+
+            if (meshDirty)
+            {
+                updateMesh();
+            }
+            else if (verticesDirty)
+            {
+                updateVertices();
+            }
+        }
+
+        void EntityStore::draw(const Matrix4& transformMatrix,
+                               const Color& drawColor,
+                               scene::Camera* camera)
+        {
+            Component::draw(transformMatrix, drawColor, camera);
+
+            if (needsMeshUpload)
+            {
+                for (uint32_t i = 0; i < meshBatchCount; ++i)
+                {
+                    MeshBatch& meshBatch = meshBatches[i];
+
+                    if (needsIndexUpload)
+                    {
+                        meshBatch.indexBuffer->setData(meshBatch.indices.data(), static_cast<uint32_t>(getVectorSize(meshBatch.indices)));
+                    }
+
+                    meshBatch.vertexBuffer->setData(meshBatch.vertices.data(), static_cast<uint32_t>(getVectorSize(meshBatch.vertices)));
+                }
+
+                needsMeshUpload = false;
+                needsIndexUpload = false;
+            }
+
+            Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix;
+            float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
+
+            for (uint32_t i = 0; i < meshBatchCount; ++i)
+            {
+                const MeshBatch& meshBatch = meshBatches[i];
+
+                FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+                FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
+
+                FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
+
+                sharedEngine->getRenderer()->addDrawCommand({meshBatch.texture},
+                                                            shader,
+                                                            pixelShaderConstants,
+                                                            vertexShaderConstants,
+                                                            blendState,
+                                                            meshBatch.meshBuffer,
+                                                            static_cast<uint32_t>(meshBatch.indices.size()),
+                                                            graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                            0,
+                                                            camera->getRenderTarget(),
+                                                            camera->getRenderViewport(),
+                                                            camera->getDepthWrite(),
+                                                            camera->getDepthTest());
+            }
+        }
+
+        void EntityStore::drawWireframe(const Matrix4& transformMatrix,
+                                        const Color& drawColor,
+                                        scene::Camera* camera)
+        {
+            Component::drawWireframe(transformMatrix, drawColor, camera);
+
+            Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix;
+            float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
+
+            for (uint32_t i = 0; i < meshBatchCount; ++i)
+            {
+                const MeshBatch& meshBatch = meshBatches[i];
+
+                FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+                FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
+
+                FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
+
+                sharedEngine->getRenderer()->addDrawCommand({whitePixelTexture},
+                                                            shader,
+                                                            pixelShaderConstants,
+                                                            vertexShaderConstants,
+                                                            blendState,
+                                                            meshBatch.meshBuffer,
+                                                            static_cast<uint32_t>(meshBatch.indices.size()),
+                                                            graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                            0,
+                                                            camera->getRenderTarget(),
+                                                            camera->getRenderViewport(),
+                                                            camera->getDepthWrite(),
+                                                            camera->getDepthTest(),
+                                                            true);
+            }
+        }
+
+        void EntityStore::setSpriteFrames(const std::vector<SpriteFrame>& newSpriteFrames)
+        {
+            spriteFrames = newSpriteFrames;
+            meshDirty = true;
+        }
+
+        EntityStore::Entity EntityStore::createEntity(uint32_t components)
+        {
+            uint32_t index;
+
+            if (!freeRecords.empty())
+            {
+                index = freeRecords.back();
+                freeRecords.pop_back();
+            }
+            else
+            {
+                if (records.size() >= ENTITY_INDEX_MASK)
+                {
+                    Log(Log::Level::ERR) << "Too many entities";
+                    return INVALID_ENTITY;
+                }
+
+                index = static_cast<uint32_t>(records.size());
+                records.push_back(EntityRecord());
+            }
+
+            Entity entity = (static_cast<Entity>(records[index].generation) << ENTITY_INDEX_BITS) | index;
+
+            Archetype& archetype = archetypes[components % ARCHETYPE_COUNT];
+
+            EntityRecord& record = records[index];
+            record.alive = true;
+            record.archetype = archetype.components;
+            record.row = archetype.getSize();
+
+            archetype.pushBack(entity);
+
+            ++entityCount;
+            if (components & SPRITE) meshDirty = true;
+
+            return entity;
+        }
+
+        bool EntityStore::destroyEntity(Entity entity)
+        {
+            if (!isAlive(entity))
+            {
+                return false;
+            }
+
+            uint32_t index = static_cast<uint32_t>(entity & ENTITY_INDEX_MASK);
+            EntityRecord& record = records[index];
+            Archetype& archetype = archetypes[record.archetype];
+
+            Entity movedEntity = archetype.swapRemove(record.row);
+
+            if (movedEntity != INVALID_ENTITY)
+            {
+                records[movedEntity & ENTITY_INDEX_MASK].row = record.row;
+            }
+
+            if (archetype.components & SPRITE) meshDirty = true;
+
+            record.alive = false;
+            ++record.generation;
+            freeRecords.push_back(index);
+
+            --entityCount;
+
+            return true;
+        }
+
+        void EntityStore::destroyAllEntities()
+        {
+            for (Archetype& archetype : archetypes)
+            {
+                uint32_t components = archetype.components;
+                archetype = Archetype();
+                archetype.components = components;
+            }
+
+            freeRecords.clear();
+
+            for (uint32_t index = 0; index < records.size(); ++index)
+            {
+                EntityRecord& record = records[index];
+
+                if (record.alive)
+                {
+                    record.alive = false;
+                    ++record.generation;
+                }
+
+                freeRecords.push_back(index);
+            }
+
+            entityCount = 0;
+            meshDirty = true;
+        }
+
+        bool EntityStore::isAlive(Entity entity) const
+        {
+            return getRecord(entity) != nullptr;
+        }
+
+        bool EntityStore::setComponents(Entity entity, uint32_t components)
+        {
+            if (!isAlive(entity))
+            {
+                return false;
+            }
+
+            EntityRecord& record = records[entity & ENTITY_INDEX_MASK];
+            Archetype& source = archetypes[record.archetype];
+            Archetype& destination = archetypes[components % ARCHETYPE_COUNT];
+
+            if (&source == &destination)
+            {
+                return true;
+            }
+
+            uint32_t row = destination.getSize();
+            destination.pushBack(entity);
+            source.copy(record.row, destination, row);
+
+            Entity movedEntity = source.swapRemove(record.row);
+
+            if (movedEntity != INVALID_ENTITY)
+            {
+                records[movedEntity & ENTITY_INDEX_MASK].row = record.row;
+            }
+
+            if ((source.components | destination.components) & SPRITE) meshDirty = true;
+
+            record.archetype = destination.components;
+            record.row = row;
+
+            return true;
+        }
+
+        uint32_t EntityStore::getComponents(Entity entity) const
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            return record ? record->archetype : 0;
+        }
+
+        bool EntityStore::setPosition(Entity entity, const Vector2& position)
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & TRANSFORM))
+            {
+                return false;
+            }
+
+            archetypes[record->archetype].positions[record->row] = position;
+            if (record->archetype & SPRITE) invalidateVertices(record->archetype, record->row);
+
+            return true;
+        }
+
+        Vector2 EntityStore::getPosition(Entity entity) const
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & TRANSFORM))
+            {
+                return Vector2();
+            }
+
+            return archetypes[record->archetype].positions[record->row];
+        }
+
+        bool EntityStore::setRotation(Entity entity, float rotation)
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & TRANSFORM))
+            {
+                return false;
+            }
+
+            archetypes[record->archetype].rotations[record->row] = rotation;
+            if (record->archetype & SPRITE) invalidateVertices(record->archetype, record->row);
+
+            return true;
+        }
+
+        float EntityStore::getRotation(Entity entity) const
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & TRANSFORM))
+            {
+                return 0.0f;
+            }
+
+            return archetypes[record->archetype].rotations[record->row];
+        }
+
+        bool EntityStore::setScale(Entity entity, const Vector2& scale)
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & TRANSFORM))
+            {
+                return false;
+            }
+
+            archetypes[record->archetype].scales[record->row] = scale;
+            if (record->archetype & SPRITE) invalidateVertices(record->archetype, record->row);
+
+            return true;
+        }
+
+        Vector2 EntityStore::getScale(Entity entity) const
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & TRANSFORM))
+            {
+                return Vector2();
+            }
+
+            return archetypes[record->archetype].scales[record->row];
+        }
+
+        bool EntityStore::setFrame(Entity entity, uint32_t frame)
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & SPRITE))
+            {
+                return false;
+            }
+
+            archetypes[record->archetype].frames[record->row] = frame;
+            meshDirty = true;
+
+            return true;
+        }
+
+        uint32_t EntityStore::getFrame(Entity entity) const
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & SPRITE))
+            {
+                return 0;
+            }
+
+            return archetypes[record->archetype].frames[record->row];
+        }
+
+        bool EntityStore::setColor(Entity entity, const Color& color)
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & SPRITE))
+            {
+                return false;
+            }
+
+            archetypes[record->archetype].colors[record->row] = color;
+            invalidateVertices(record->archetype, record->row);
+
+            return true;
+        }
+
+        Color EntityStore::getColor(Entity entity) const
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & SPRITE))
+            {
+                return Color();
+            }
+
+            return archetypes[record->archetype].colors[record->row];
+        }
+
+        bool EntityStore::setVelocity(Entity entity, const Vector2& velocity, float angularVelocity)
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & VELOCITY))
+            {
+                return false;
+            }
+
+            archetypes[record->archetype].velocities[record->row] = velocity;
+            archetypes[record->archetype].angularVelocities[record->row] = angularVelocity;
+
+            return true;
+        }
+
+        Vector2 EntityStore::getVelocity(Entity entity) const
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & VELOCITY))
+            {
+                return Vector2();
+            }
+
+            return archetypes[record->archetype].velocities[record->row];
+        }
+
+        float EntityStore::getAngularVelocity(Entity entity) const
+        {
+            const EntityRecord* record = getRecord(entity);
+
+            if (!record || !(record->archetype & VELOCITY))
+            {
+                return 0.0f;
+            }
+
+            return archetypes[record->archetype].angularVelocities[record->row];
+        }
+
+        void EntityStore::forEachArchetype(uint32_t components, const std::function<void(Archetype&)>& function)
+        {
+            for (Archetype& archetype : archetypes)
+            {
+                if ((archetype.components & components) == components &&
+                    !archetype.entities.empty())
+                {
+                    function(archetype);
+                }
+            }
+        }
+
+        const EntityStore::EntityRecord* EntityStore::getRecord(Entity entity) const
+        {
+            uint64_t index = entity & ENTITY_INDEX_MASK;
+
+            if (index >= records.size())
+            {
+                return nullptr;
+            }
+
+            const EntityRecord& record = records[index];
+
+            if (!record.alive || record.generation != static_cast<uint32_t>(entity >> ENTITY_INDEX_BITS))
+            {
+                return nullptr;
+            }
+
+            return &record;
+        }
+
+        void EntityStore::invalidateVertices(uint32_t archetype, uint32_t row)
+        {
+            ArchetypeMesh& archetypeMesh = archetypeMeshes[archetype];
+
+            if (!archetypeMesh.dirty)
+            {
+                // rewriting the whole archetype is cheaper than going through a long list of rows
+                if (archetypeMesh.dirtyRows.size() < archetypes[archetype].getSize() / 4)
+                {
+                    archetypeMesh.dirtyRows.push_back(row);
+                }
+                else
+                {
+                    archetypeMesh.dirty = true;
+                }
+            }
+
+            verticesDirty = true;
+        }
+
+        void EntityStore::updateMesh()
+        {
+            // render system, builds one mesh per texture (and per 65536 vertices)
+            for (uint32_t i = 0; i < meshBatchCount; ++i)
+            {
+                meshBatches[i].indices.clear();
+                meshBatches[i].vertices.clear();
+            }
+
+            meshBatchCount = 0;
+
+            for (uint32_t i = 0; i < ARCHETYPE_COUNT; ++i)
+            {
+                const Archetype& archetype = archetypes[i];
+                ArchetypeMesh& archetypeMesh = archetypeMeshes[i];
+
+                archetypeMesh.dirtyRows.clear();
+
+                if ((archetype.components & (TRANSFORM | SPRITE)) != (TRANSFORM | SPRITE))
+                {
+                    archetypeMesh.dirty = false;
+                    continue;
+                }
+
+                uint32_t count = archetype.getSize();
+
+                archetypeMesh.meshBatches.assign(count, INVALID_MESH_BATCH);
+                archetypeMesh.baseVertices.assign(count, 0);
+                archetypeMesh.dirty = true;
+
+                for (uint32_t row = 0; row < count; ++row)
+                {
+                    uint32_t frameIndex = archetype.frames[row];
+
+                    if (frameIndex >= spriteFrames.size())
+                    {
+                        continue;
+                    }
+
+                    const SpriteFrame& frame = spriteFrames[frameIndex];
+                    const std::vector<uint16_t>& frameIndices = frame.getIndices();
+                    uint32_t frameVertexCount = static_cast<uint32_t>(frame.getVertices().size());
+
+                    MeshBatch& meshBatch = getMeshBatch(frame.getTexture(), frameVertexCount);
+
+                    uint32_t baseVertex = static_cast<uint32_t>(meshBatch.vertices.size());
+
+                    for (uint16_t index : frameIndices)
+                    {
+                        meshBatch.indices.push_back(static_cast<uint16_t>(baseVertex + index));
+                    }
+
+                    // the vertices are written by updateVertices
+                    meshBatch.vertices.resize(baseVertex + frameVertexCount);
+
+                    archetypeMesh.meshBatches[row] = static_cast<uint32_t>(&meshBatch - meshBatches.data());
+                    archetypeMesh.baseVertices[row] = baseVertex;
+                }
+            }
+
+            meshDirty = false;
+            needsIndexUpload = true;
+
+            updateVertices();
+        }
+
+        void EntityStore::updateVertices()
+        {
+            AABB3 newBoundingBox;
+
+            for (uint32_t i = 0; i < ARCHETYPE_COUNT; ++i)
+            {
+                const Archetype& archetype = archetypes[i];
+                ArchetypeMesh& archetypeMesh = archetypeMeshes[i];
+
+                if ((archetype.components & (TRANSFORM | SPRITE)) != (TRANSFORM | SPRITE))
+                {
+                    continue;
+                }
+
+                if (archetypeMesh.dirty)
+                {
+                    uint32_t count = archetype.getSize();
+
+                    sines.resize(count);
+                    cosines.resize(count);
+                    sinCos(archetype.rotations.data(), sines.data(), cosines.data(), count);
+
+                    archetypeMesh.boundingBox.reset();
+
+                    for (uint32_t row = 0; row < count; ++row)
+                    {
+                        writeVertices(i, row, sines[row], cosines[row]);
+                    }
+                }
+                else
+                {
+                    // the bounding box of the archetype only grows until all of its rows are written again
+                    for (uint32_t row : archetypeMesh.dirtyRows)
+                    {
+                        float rotation = archetype.rotations[row];
+                        writeVertices(i, row, sinf(rotation), cosf(rotation));
+                    }
+                }
+
+                archetypeMesh.dirty = false;
+                archetypeMesh.dirtyRows.clear();
+
+                if (!archetypeMesh.boundingBox.isEmpty())
+                {
+                    newBoundingBox.insertPoint(archetypeMesh.boundingBox.min);
+                    newBoundingBox.insertPoint(archetypeMesh.boundingBox.max);
+                }
+            }
+
+            boundingBox = newBoundingBox;
+
+            verticesDirty = false;
+            needsMeshUpload = true;
+
+            invalidateNode();
+        }
+
+        void EntityStore::writeVertices(uint32_t archetypeIndex, uint32_t row, float sinRotation, float cosRotation)
+        {
+            const Archetype& archetype = archetypes[archetypeIndex];
+            ArchetypeMesh& archetypeMesh = archetypeMeshes[archetypeIndex];
+
+            uint32_t meshBatchIndex = archetypeMesh.meshBatches[row];
+
+            if (meshBatchIndex == INVALID_MESH_BATCH)
+            {
+                return;
+            }
+
+            const std::vector<graphics::VertexPCT>& frameVertices = spriteFrames[archetype.frames[row]].getVertices();
+            graphics::VertexPCT* vertices = meshBatches[meshBatchIndex].vertices.data() + archetypeMesh.baseVertices[row];
+
+            const Vector2& position = archetype.positions[row];
+            const Vector2& scale = archetype.scales[row];
+            const Color& color = archetype.colors[row];
+
+            for (uint32_t i = 0; i < frameVertices.size(); ++i)
+            {
+                const graphics::VertexPCT& frameVertex = frameVertices[i];
+                graphics::VertexPCT& vertex = vertices[i];
+
+                float x = frameVertex.position.v[0] * scale.v[0];
+                float y = frameVertex.position.v[1] * scale.v[1];
+
+                vertex.position.v[0] = position.v[0] + cosRotation * x - sinRotation * y;
+                vertex.position.v[1] = position.v[1] + sinRotation * x + cosRotation * y;
+                vertex.position.v[2] = 0.0f;
+                vertex.color = color;
+                vertex.texCoord = frameVertex.texCoord;
+
+                archetypeMesh.boundingBox.insertPoint(vertex.position);
+            }
+        }
+
+        EntityStore::MeshBatch& EntityStore::getMeshBatch(const std::shared_ptr<graphics::Texture>& texture, uint32_t vertexCount)
+        {
+            for (uint32_t i = meshBatchCount; i > 0; --i)
+            {
+                MeshBatch& meshBatch = meshBatches[i - 1];
+
+                if (meshBatch.texture == texture &&
+                    meshBatch.vertices.size() + vertexCount <= MAX_BATCH_VERTICES)
+                {
+                    return meshBatch;
+                }
+            }
+
+            if (meshBatchCount >= meshBatches.size())
+            {
+                MeshBatch meshBatch;
+
+                meshBatch.indexBuffer = std::make_shared<graphics::Buffer>();
+                meshBatch.indexBuffer->init(graphics::Buffer::Usage::INDEX);
+
+                meshBatch.vertexBuffer = std::make_shared<graphics::Buffer>();
+                meshBatch.vertexBuffer->init(graphics::Buffer::Usage::VERTEX);
+
+                meshBatch.meshBuffer = std::make_shared<graphics::MeshBuffer>();
+                meshBatch.meshBuffer->init(sizeof(uint16_t), meshBatch.indexBuffer, graphics::VertexPCT::ATTRIBUTES, meshBatch.vertexBuffer);
+
+                meshBatches.push_back(meshBatch);
+            }
+
+            MeshBatch& meshBatch = meshBatches[meshBatchCount++];
+            meshBatch.texture = texture;
+
+            return meshBatch;
+        }
+    } // namespace scene
+} // namespace ouzel
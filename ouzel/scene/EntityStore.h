@@ -0,0 +1,182 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "scene/Component.h"
+#include "scene/SpriteFrame.h"
+#include "math/Color.h"
+#include "math/Vector2.h"
+#include "graphics/Vertex.h"
+#include "core/UpdateCallback.h"
+#include "graphics/BlendState.h"
+#include "graphics/Buffer.h"
+#include "graphics/MeshBuffer.h"
+#include "graphics/Shader.h"
+#include "graphics/Texture.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Stores lightweight entities in packed arrays, one set of arrays per combination of components (archetype).
+        // The whole store is drawn by the node it is added to, so it is sorted, culled and picked as one component.
+        class EntityStore: public Component
+        {
+        public:
+            // index of the entity in the low 32 bits and the generation of the index in the high 32 bits
+            typedef uint64_t Entity;
+
+            static const Entity INVALID_ENTITY = 0xFFFFFFFFFFFFFFFF;
+
+            enum ComponentType
+            {
+                TRANSFORM = 0x01,
+                SPRITE = 0x02,
+                VELOCITY = 0x04
+            };
+
+            static const uint32_t ARCHETYPE_COUNT = 8;
+
+            struct Archetype
+            {
+                uint32_t components = 0;
+                std::vector<Entity> entities;
+
+                // TRANSFORM
+                std::vector<Vector2> positions;
+                std::vector<float> rotations;
+                std::vector<Vector2> scales;
+
+                // SPRITE
+                std::vector<uint32_t> frames;
+                std::vector<Color> colors;
+
+                // VELOCITY
+                std::vector<Vector2> velocities;
+                std::vector<float> angularVelocities;
+
+                uint32_t getSize() const { return static_cast<uint32_t>(entities.size()); }
+
+                void pushBack(Entity entity);
+                Entity swapRemove(uint32_t row);
+                void copy(uint32_t row, Archetype& destination, uint32_t destinationRow) const;
+            };
+
+            EntityStore();
+            virtual ~EntityStore();
+
+            virtual void update(float delta);
+
+            virtual void draw(const Matrix4& transformMatrix,
+                              const Color& drawColor,
+                              scene::Camera* camera) override;
+
+            virtual void drawWireframe(const Matrix4& transformMatrix,
+                                       const Color& drawColor,
+                                       scene::Camera* camera) override;
+
+            void setSpriteFrames(const std::vector<SpriteFrame>& newSpriteFrames);
+            const std::vector<SpriteFrame>& getSpriteFrames() const { return spriteFrames; }
+
+            virtual const std::shared_ptr<graphics::BlendState>& getBlendState() const { return blendState; }
+            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState) { blendState = newBlendState; }
+
+            Entity createEntity(uint32_t components);
+            bool destroyEntity(Entity entity);
+            void destroyAllEntities();
+            bool isAlive(Entity entity) const;
+            uint32_t getEntityCount() const { return entityCount; }
+
+            bool setComponents(Entity entity, uint32_t components);
+            uint32_t getComponents(Entity entity) const;
+
+            bool setPosition(Entity entity, const Vector2& position);
+            Vector2 getPosition(Entity entity) const;
+            bool setRotation(Entity entity, float rotation);
+            float getRotation(Entity entity) const;
+            bool setScale(Entity entity, const Vector2& scale);
+            Vector2 getScale(Entity entity) const;
+
+            bool setFrame(Entity entity, uint32_t frame);
+            uint32_t getFrame(Entity entity) const;
+            bool setColor(Entity entity, const Color& color);
+            Color getColor(Entity entity) const;
+
+            bool setVelocity(Entity entity, const Vector2& velocity, float angularVelocity = 0.0f);
+            Vector2 getVelocity(Entity entity) const;
+            float getAngularVelocity(Entity entity) const;
+
+            // calls the function for every archetype that has all of the given components
+            void forEachArchetype(uint32_t components, const std::function<void(Archetype&)>& function);
+
+            // must be called after the archetype arrays were modified directly
+            void invalidateMesh() { meshDirty = true; }
+
+        protected:
+            struct EntityRecord
+            {
+                uint32_t generation = 0;
+                uint32_t archetype = 0;
+                uint32_t row = 0;
+                bool alive = false;
+            };
+
+            // where the vertices of the sprites of an archetype are, so moved sprites are rewritten in place
+            struct ArchetypeMesh
+            {
+                // mesh batch (or INVALID_MESH_BATCH) and the first vertex of every row, set when the mesh is rebuilt
+                std::vector<uint32_t> meshBatches;
+                std::vector<uint32_t> baseVertices;
+
+                bool dirty = false; // all rows
+                std::vector<uint32_t> dirtyRows;
+                AABB3 boundingBox;
+            };
+
+            struct MeshBatch
+            {
+                std::shared_ptr<graphics::Texture> texture;
+                std::vector<uint16_t> indices;
+                std::vector<graphics::VertexPCT> vertices;
+
+                std::shared_ptr<graphics::MeshBuffer> meshBuffer;
+                std::shared_ptr<graphics::Buffer> indexBuffer;
+                std::shared_ptr<graphics::Buffer> vertexBuffer;
+            };
+
+            const EntityRecord* getRecord(Entity entity) const;
+
+            void invalidateVertices(uint32_t archetype, uint32_t row);
+            void updateMesh();
+            void updateVertices();
+            void writeVertices(uint32_t archetypeIndex, uint32_t row, float sinRotation, float cosRotation);
+            MeshBatch& getMeshBatch(const std::shared_ptr<graphics::Texture>& texture, uint32_t vertexCount);
+
+            std::shared_ptr<graphics::Shader> shader;
+            std::shared_ptr<graphics::BlendState> blendState;
+            std::shared_ptr<graphics::Texture> whitePixelTexture;
+
+            std::vector<SpriteFrame> spriteFrames;
+
+            Archetype archetypes[ARCHETYPE_COUNT];
+            std::vector<EntityRecord> records;
+            std::vector<uint32_t> freeRecords;
+            uint32_t entityCount = 0;
+
+            std::vector<MeshBatch> meshBatches;
+            uint32_t meshBatchCount = 0;
+            ArchetypeMesh archetypeMeshes[ARCHETYPE_COUNT];
+            std::vector<float> sines;
+            std::vector<float> cosines;
+            bool meshDirty = false; // sprites were added, removed or changed their frame
+            bool verticesDirty = false; // sprites were moved or changed their color
+            bool needsMeshUpload = false;
+            bool needsIndexUpload = false;
+
+            UpdateCallback updateCallback;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -31,16 +31,112 @@ namespace ouzel
 
         void Layer::draw()
         {
-            for (Camera* camera : cameras)
+            if (drawIndicesDirty)
             {
-                std::vector<Node*> drawQueue;
+                uint32_t nextDrawIndex = 0;
 
                 for (Node* child : children)
                 {
-                    child->visit(drawQueue, Matrix4::IDENTITY, false, camera, 0, false);
+                    child->updateDrawIndex(nextDrawIndex);
+                }
+
+                drawIndicesDirty = false;
+            }
+
+            if (!drawQueueRetained)
+            {
+                for (Camera* camera : cameras)
+                {
+                    // the queue is rebuilt every frame, so it lives in the frame memory
+                    FrameVector<Node*> drawQueue(sharedEngine->getFrameAllocator());
+
+                    for (Node* child : children)
+                    {
+                        child->visit(drawQueue, Matrix4::IDENTITY, false, camera, 0, false);
+                    }
+
+                    for (Node* node : drawQueue)
+                    {
+                        node->draw(camera);
+
+                        if (camera->getWireframe())
+                        {
+                            node->drawWireframe(camera);
+                        }
+                    }
+                }
+
+                return;
+            }
+
+            // nodes that have a changed ancestor are visited together with it
+            FrameVector<Node*> changedNodes(sharedEngine->getFrameAllocator());
+
+            for (Node* node : dirtyNodes)
+            {
+                bool ancestorChanged = false;
+
+                for (NodeContainer* container = node->parent; container && container != this;)
+                {
+                    Node* parentNode = static_cast<Node*>(container);
+
+                    if (parentNode->drawQueueDirty)
+                    {
+                        ancestorChanged = true;
+                        break;
+                    }
+
+                    container = parentNode->parent;
                 }
 
-                for (Node* node : drawQueue)
+                if (!ancestorChanged) changedNodes.push_back(node);
+            }
+
+            dirtyNodes.clear();
+
+            for (Camera* camera : cameras)
+            {
+                DrawQueue& drawQueue = drawQueues[camera];
+
+                if (!drawQueue.valid || !(drawQueue.viewProjection == camera->getViewProjection()))
+                {
+                    drawQueue.nodes.clear();
+
+                    for (Node* child : children)
+                    {
+                        child->visit(drawQueue.nodes, Matrix4::IDENTITY, false, camera, 0, false);
+                    }
+
+                    drawQueue.viewProjection = camera->getViewProjection();
+                    drawQueue.valid = true;
+                }
+                else if (!changedNodes.empty())
+                {
+                    for (Node* node : changedNodes)
+                    {
+                        node->markDrawQueueDirty();
+                    }
+
+                    drawQueue.nodes.erase(std::remove_if(drawQueue.nodes.begin(), drawQueue.nodes.end(),
+                                                         [](Node* node) { return node->drawQueueDirty; }),
+                                          drawQueue.nodes.end());
+
+                    for (Node* node : changedNodes)
+                    {
+                        if (node->parent == this)
+                        {
+                            node->visit(drawQueue.nodes, Matrix4::IDENTITY, false, camera, 0, false);
+                        }
+                        else
+                        {
+                            Node* parentNode = static_cast<Node*>(node->parent);
+                            node->visit(drawQueue.nodes, parentNode->getTransform(), false, camera,
+                                        parentNode->worldOrder, parentNode->worldHidden);
+                        }
+                    }
+                }
+
+                for (Node* node : drawQueue.nodes)
                 {
                     node->draw(camera);
 
@@ -58,6 +154,7 @@ namespace ouzel
 
             if (node)
             {
+                node->parentIsNode = false;
                 node->updateTransform(Matrix4::IDENTITY);
             }
         }
@@ -88,6 +185,37 @@ namespace ouzel
             {
                 camera->layer = nullptr;
                 cameras.erase(i);
+                drawQueues.erase(camera);
+            }
+        }
+
+        void Layer::setDrawQueueRetained(bool newDrawQueueRetained)
+        {
+            drawQueueRetained = newDrawQueueRetained;
+
+            drawQueues.clear();
+            dirtyNodes.clear();
+        }
+
+        void Layer::nodeChanged(Node* node)
+        {
+            if (drawQueueRetained && !node->drawQueueDirty)
+            {
+                node->drawQueueDirty = true;
+                dirtyNodes.push_back(node);
+            }
+        }
+
+        void Layer::childrenChanged()
+        {
+            drawIndicesDirty = true;
+
+            // nodes could have been deleted, so the draw queues are rebuilt from scratch
+            dirtyNodes.clear();
+
+            for (auto& drawQueue : drawQueues)
+            {
+                drawQueue.second.valid = false;
             }
         }
 
@@ -97,7 +225,7 @@ namespace ouzel
             {
                 Camera* camera = *i;
 
-                std::vector<Node*> nodes;
+                FrameVector<Node*> nodes(sharedEngine->getFrameAllocator());
 
                 Vector2 worldPosition = camera->convertNormalizedToWorld(position);
 
@@ -119,7 +247,7 @@ namespace ouzel
 
                 Vector2 worldPosition = camera->convertNormalizedToWorld(position);
 
-                std::vector<Node*> nodes;
+                FrameVector<Node*> nodes(sharedEngine->getFrameAllocator());
                 findNodes(worldPosition, nodes);
 
                 result.insert(result.end(), nodes.begin(), nodes.end());
@@ -136,7 +264,7 @@ namespace ouzel
             {
                 Camera* camera = *i;
 
-                std::vector<Vector2> worldEdges;
+                FrameVector<Vector2> worldEdges(sharedEngine->getFrameAllocator());
                 worldEdges.reserve(edges.size());
 
                 for (const Vector2& edge : edges)
@@ -144,7 +272,7 @@ namespace ouzel
                     worldEdges.push_back(camera->convertNormalizedToWorld(edge));
                 }
 
-                std::vector<Node*> nodes;
+                FrameVector<Node*> nodes(sharedEngine->getFrameAllocator());
                 findNodes(worldEdges, nodes);
 
                 result.insert(result.end(), nodes.begin(), nodes.end());
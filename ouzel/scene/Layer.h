@@ -4,8 +4,10 @@
 #pragma once
 
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 #include "scene/NodeContainer.h"
+#include "math/Matrix4.h"
 #include "math/Vector2.h"
 
 namespace ouzel
@@ -38,15 +40,34 @@ namespace ouzel
             int32_t getOrder() const { return order; }
             void setOrder(int32_t newOrder);
 
+            // keeps the draw queues between frames and only updates the changed nodes
+            void setDrawQueueRetained(bool newDrawQueueRetained);
+            bool isDrawQueueRetained() const { return drawQueueRetained; }
+
         protected:
+            struct DrawQueue
+            {
+                Matrix4 viewProjection;
+                FrameVector<Node*> nodes;
+                bool valid = false;
+            };
+
             virtual void recalculateProjection();
             virtual void enter() override;
 
+            virtual void nodeChanged(Node* node) override;
+            virtual void childrenChanged() override;
+
             Scene* scene = nullptr;
 
             std::vector<Camera*> cameras;
 
             int32_t order = 0;
+
+            bool drawQueueRetained = false;
+            bool drawIndicesDirty = true;
+            std::unordered_map<Camera*, DrawQueue> drawQueues;
+            std::vector<Node*> dirtyNodes;
         };
     } // namespace scene
 } // namespace ouzel
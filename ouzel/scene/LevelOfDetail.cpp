@@ -0,0 +1,206 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "LevelOfDetail.h"
+#include "Camera.h"
+#include "Node.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        LevelOfDetail::LevelOfDetail(float aHysteresis):
+            hysteresis(aHysteresis)
+        {
+        }
+
+        LevelOfDetail::~LevelOfDetail()
+        {
+            for (const Level& level : levels)
+            {
+                level.component->levelOfDetail = nullptr;
+            }
+        }
+
+        void LevelOfDetail::draw(const Matrix4& transformMatrix,
+                                 const Color& drawColor,
+                                 scene::Camera* camera)
+        {
+            Component::draw(transformMatrix, drawColor, camera);
+
+            updateLevel(transformMatrix, camera);
+
+            if (currentLevel < levels.size())
+            {
+                Component* component = levels[currentLevel].component;
+
+                if (!component->isHidden())
+                {
+                    component->draw(transformMatrix, drawColor, camera);
+                }
+            }
+        }
+
+        void LevelOfDetail::drawWireframe(const Matrix4& transformMatrix,
+                                          const Color& drawColor,
+                                          scene::Camera* camera)
+        {
+            Component::drawWireframe(transformMatrix, drawColor, camera);
+
+            if (currentLevel < levels.size())
+            {
+                Component* component = levels[currentLevel].component;
+
+                if (!component->isHidden())
+                {
+                    component->drawWireframe(transformMatrix, drawColor, camera);
+                }
+            }
+        }
+
+        const AABB3& LevelOfDetail::getBoundingBox() const
+        {
+            if (currentLevel < levels.size())
+            {
+                return levels[currentLevel].component->getBoundingBox();
+            }
+
+            return boundingBox;
+        }
+
+        bool LevelOfDetail::pointOn(const Vector2& position) const
+        {
+            if (currentLevel < levels.size())
+            {
+                return levels[currentLevel].component->pointOn(position);
+            }
+
+            return false;
+        }
+
+        bool LevelOfDetail::shapeOverlaps(const FrameVector<Vector2>& edges) const
+        {
+            if (currentLevel < levels.size())
+            {
+                return levels[currentLevel].component->shapeOverlaps(edges);
+            }
+
+            return false;
+        }
+
+        void LevelOfDetail::addLevel(Component* component, float minSize)
+        {
+            if (component->node)
+            {
+                component->node->removeComponent(component);
+            }
+
+            if (component->levelOfDetail)
+            {
+                component->levelOfDetail->removeLevel(component);
+            }
+
+            component->levelOfDetail = this;
+
+            Level level;
+            level.component = component;
+            level.minSize = minSize;
+
+            // levels are kept from the most to the least detailed
+            auto upperBound = std::upper_bound(levels.begin(), levels.end(), level,
+                                               [](const Level& a, const Level& b) {
+                                                   return a.minSize > b.minSize;
+                                               });
+
+            if (upperBound - levels.begin() <= static_cast<int32_t>(currentLevel) && !levels.empty())
+            {
+                ++currentLevel;
+            }
+
+            levels.insert(upperBound, level);
+
+            invalidateNode();
+        }
+
+        bool LevelOfDetail::removeLevel(Component* component)
+        {
+            for (auto i = levels.begin(); i != levels.end(); ++i)
+            {
+                if (i->component == component)
+                {
+                    uint32_t index = static_cast<uint32_t>(i - levels.begin());
+                    component->levelOfDetail = nullptr;
+                    levels.erase(i);
+
+                    if (index < currentLevel)
+                    {
+                        --currentLevel;
+                    }
+                    else if (currentLevel >= levels.size())
+                    {
+                        currentLevel = levels.empty() ? 0 : static_cast<uint32_t>(levels.size() - 1);
+                    }
+
+                    invalidateNode();
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void LevelOfDetail::removeAllLevels()
+        {
+            for (const Level& level : levels)
+            {
+                level.component->levelOfDetail = nullptr;
+            }
+
+            levels.clear();
+            currentLevel = 0;
+
+            invalidateNode();
+        }
+
+        void LevelOfDetail::updateLevel(const Matrix4& transformMatrix, scene::Camera* camera)
+        {
+            if (levels.size() < 2)
+            {
+                return;
+            }
+
+            // the most detailed level is measured, so that switching levels doesn't change the measured size
+            const AABB3& referenceBoundingBox = levels.front().component->getBoundingBox();
+
+            if (referenceBoundingBox.isEmpty())
+            {
+                return;
+            }
+
+            Size2 screenSize = camera->getScreenSize(transformMatrix, referenceBoundingBox);
+            float size = std::max(screenSize.v[0], screenSize.v[1]);
+
+            uint32_t level = currentLevel;
+
+            while (level > 0 && size >= levels[level - 1].minSize * (1.0f + hysteresis))
+            {
+                --level;
+            }
+
+            while (level + 1 < levels.size() && size < levels[level].minSize * (1.0f - hysteresis))
+            {
+                ++level;
+            }
+
+            if (level != currentLevel)
+            {
+                currentLevel = level;
+
+                // bounding box of the new level is used for culling
+                invalidateNode();
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
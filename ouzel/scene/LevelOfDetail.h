@@ -0,0 +1,59 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include "scene/Component.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class LevelOfDetail: public Component
+        {
+        public:
+            LevelOfDetail(float aHysteresis = 0.1f);
+            virtual ~LevelOfDetail();
+
+            virtual void draw(const Matrix4& transformMatrix,
+                              const Color& drawColor,
+                              scene::Camera* camera) override;
+
+            virtual void drawWireframe(const Matrix4& transformMatrix,
+                                       const Color& drawColor,
+                                       scene::Camera* camera) override;
+
+            virtual const AABB3& getBoundingBox() const override;
+
+            virtual bool pointOn(const Vector2& position) const override;
+            virtual bool shapeOverlaps(const FrameVector<Vector2>& edges) const override;
+
+            // component is used while its on-screen size (in pixels) is at least minSize, it is removed from its node and
+            // its previous level of detail and it removes itself from the level of detail when it is destroyed
+            void addLevel(Component* component, float minSize);
+            bool removeLevel(Component* component);
+            void removeAllLevels();
+
+            uint32_t getLevelCount() const { return static_cast<uint32_t>(levels.size()); }
+            Component* getLevel(uint32_t index) const { return index < levels.size() ? levels[index].component : nullptr; }
+            uint32_t getCurrentLevel() const { return currentLevel; }
+
+            float getHysteresis() const { return hysteresis; }
+            void setHysteresis(float newHysteresis) { hysteresis = newHysteresis; }
+
+        protected:
+            struct Level
+            {
+                Component* component;
+                float minSize;
+            };
+
+            void updateLevel(const Matrix4& transformMatrix, scene::Camera* camera);
+
+            std::vector<Level> levels;
+            uint32_t currentLevel = 0;
+            float hysteresis;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -8,9 +8,12 @@
 #include "Layer.h"
 #include "animators/Animator.h"
 #include "Camera.h"
+#include "utils/MemoryTracker.h"
 #include "utils/Utils.h"
 #include "math/MathUtils.h"
 #include "Component.h"
+#include "StaticBatch.h"
+#include "LevelOfDetail.h"
 
 namespace ouzel
 {
@@ -18,12 +21,18 @@ namespace ouzel
     {
         Node::Node()
         {
-            animationUpdateCallback.callback = std::bind(&Node::updateAnimation, this, std::placeholders::_1);
+            MemoryTracker::allocate(MemoryTracker::Tag::SCENE, sizeof(Node));
         }
 
         Node::~Node()
         {
-            if (currentAnimator) currentAnimator->parentNode = nullptr;
+            MemoryTracker::deallocate(MemoryTracker::Tag::SCENE, sizeof(Node));
+
+            if (currentAnimator)
+            {
+                currentAnimator->parentNode = nullptr;
+                sharedEngine->getAnimationManager()->removeAnimation(currentAnimator);
+            }
 
             for (Component* component : components)
             {
@@ -38,7 +47,7 @@ namespace ouzel
             if (parent) parent->removeChild(this);
         }
 
-        void Node::visit(std::vector<Node*>& drawQueue,
+        void Node::visit(FrameVector<Node*>& drawQueue,
                          const Matrix4& newParentTransform,
                          bool parentTransformDirty,
                          Camera* camera,
@@ -47,6 +56,7 @@ namespace ouzel
         {
             worldOrder = parentOrder + order;
             worldHidden = parentHidden || hidden;
+            drawQueueDirty = false;
 
             if (parentTransformDirty)
             {
@@ -58,6 +68,35 @@ namespace ouzel
                 calculateTransform();
             }
 
+            if (staticBatch)
+            {
+                if (staticBatchDirty)
+                {
+                    bakeStaticBatch();
+                }
+                else if (updateChildrenTransform)
+                {
+                    FrameVector<std::pair<Node*, Matrix4>> nodes(sharedEngine->getFrameAllocator());
+                    updateStaticChildren(nodes, Matrix4::IDENTITY);
+                }
+
+                const AABB3& boundingBox = staticBatch->getBoundingBox();
+
+                if (!worldHidden &&
+                    (cullDisabled || staticBatch->isUnbounded() ||
+                     (!boundingBox.isEmpty() && camera->checkVisibility(getTransform(), boundingBox))))
+                {
+                    // a function pointer passed to upper_bound is not inlined, a lambda is
+                    auto upperBound = std::upper_bound(drawQueue.begin(), drawQueue.end(), this,
+                                                       [](Node* a, Node* b) { return compareDrawOrder(a, b); });
+
+                    drawQueue.insert(upperBound, this);
+                }
+
+                updateChildrenTransform = false;
+                return;
+            }
+
             if (!worldHidden)
             {
                 AABB3 boundingBox = getBoundingBox();
@@ -65,9 +104,7 @@ namespace ouzel
                 if (cullDisabled || (!boundingBox.isEmpty() && camera->checkVisibility(getTransform(), boundingBox)))
                 {
                     auto upperBound = std::upper_bound(drawQueue.begin(), drawQueue.end(), this,
-                                                       [](Node* a, Node* b) {
-                                                           return a->worldOrder > b->worldOrder;
-                                                       });
+                                                       [](Node* a, Node* b) { return compareDrawOrder(a, b); });
 
                     drawQueue.insert(upperBound, this);
                 }
@@ -83,9 +120,12 @@ namespace ouzel
 
         void Node::draw(Camera* camera)
         {
-            if (transformDirty)
+            const Matrix4& currentTransform = getDrawTransform();
+
+            if (staticBatch)
             {
-                calculateTransform();
+                staticBatch->draw(currentTransform, camera, false);
+                return;
             }
 
             Color drawColor(color.v[0], color.v[1], color.v[2], static_cast<uint8_t>(color.v[3] * opacity));
@@ -94,16 +134,19 @@ namespace ouzel
             {
                 if (!component->isHidden())
                 {
-                    component->draw(transform, drawColor, camera);
+                    component->draw(currentTransform, drawColor, camera);
                 }
             }
         }
 
         void Node::drawWireframe(Camera* camera)
         {
-            if (transformDirty)
+            const Matrix4& currentTransform = getDrawTransform();
+
+            if (staticBatch)
             {
-                calculateTransform();
+                staticBatch->draw(currentTransform, camera, true);
+                return;
             }
 
             Color drawColor(color.v[0], color.v[1], color.v[2], 255);
@@ -112,7 +155,7 @@ namespace ouzel
             {
                 if (!component->isHidden())
                 {
-                    component->drawWireframe(transform, drawColor, camera);
+                    component->drawWireframe(currentTransform, drawColor, camera);
                 }
             }
         }
@@ -123,6 +166,7 @@ namespace ouzel
 
             if (node)
             {
+                node->parentIsNode = true;
                 node->updateTransform(getTransform());
             }
         }
@@ -140,10 +184,14 @@ namespace ouzel
             if (position.v[0] != newPosition.v[0] ||
                 position.v[1] != newPosition.v[1])
             {
+                savePreviousState();
+
                 position.v[0] = newPosition.v[0];
                 position.v[1] = newPosition.v[1];
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
@@ -151,9 +199,13 @@ namespace ouzel
         {
             if (position != newPosition)
             {
+                savePreviousState();
+
                 position = newPosition;
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
@@ -161,9 +213,13 @@ namespace ouzel
         {
             if (rotation != newRotation)
             {
+                savePreviousState();
+
                 rotation = newRotation;
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
@@ -174,9 +230,13 @@ namespace ouzel
 
             if (rotation != roationQuaternion)
             {
+                savePreviousState();
+
                 rotation = roationQuaternion;
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
@@ -187,9 +247,13 @@ namespace ouzel
 
             if (rotation != roationQuaternion)
             {
+                savePreviousState();
+
                 rotation = roationQuaternion;
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
@@ -198,10 +262,14 @@ namespace ouzel
             if (scale.v[0] != newScale.v[0] ||
                 scale.v[1] != newScale.v[1])
             {
+                savePreviousState();
+
                 scale.v[0] = newScale.v[0];
                 scale.v[1] = newScale.v[1];
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
@@ -209,20 +277,38 @@ namespace ouzel
         {
             if (scale != newScale)
             {
+                savePreviousState();
+
                 scale = newScale;
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
+            }
+        }
+
+        void Node::setOrder(int32_t newOrder)
+        {
+            if (order != newOrder)
+            {
+                order = newOrder;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
         void Node::setColor(const Color& newColor)
         {
             color = newColor;
+
+            nodeChanged(this);
         }
 
         void Node::setOpacity(float newOpacity)
         {
             opacity = clamp(newOpacity, 0.0f, 1.0f);
+
+            nodeChanged(this);
         }
 
         void Node::setFlipX(bool newFlipX)
@@ -232,6 +318,8 @@ namespace ouzel
                 flipX = newFlipX;
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
@@ -242,12 +330,50 @@ namespace ouzel
                 flipY = newFlipY;
 
                 localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+                if (parent) parent->nodeChanged(this);
             }
         }
 
         void Node::setHidden(bool newHidden)
         {
-            hidden = newHidden;
+            if (hidden != newHidden)
+            {
+                hidden = newHidden;
+
+                if (parent) parent->nodeChanged(this);
+            }
+        }
+
+        void Node::setCullDisabled(bool newCullDisabled)
+        {
+            if (cullDisabled != newCullDisabled)
+            {
+                cullDisabled = newCullDisabled;
+
+                if (parent) parent->nodeChanged(this);
+            }
+        }
+
+        void Node::setStatic(bool newStatic)
+        {
+            if (newStatic)
+            {
+                if (staticBatch) return;
+
+                staticBatch.reset(new StaticBatch());
+                staticBatchDirty = true;
+            }
+            else
+            {
+                if (!staticBatch) return;
+
+                staticBatch.reset();
+                updateChildrenTransform = true;
+            }
+
+            // the children enter or leave the retained draw queues, so they have to be rebuilt
+            if (parent) parent->childrenChanged();
         }
 
         bool Node::pointOn(const Vector2& worldPosition) const
@@ -265,11 +391,12 @@ namespace ouzel
             return false;
         }
 
-        bool Node::shapeOverlaps(const std::vector<Vector2>& edges) const
+        bool Node::shapeOverlaps(const FrameVector<Vector2>& edges) const
         {
             Matrix4 inverse = getInverseTransform();
 
-            std::vector<Vector2> transformedEdges;
+            FrameVector<Vector2> transformedEdges(sharedEngine->getFrameAllocator());
+            transformedEdges.reserve(edges.size());
 
             for (const Vector2& edge : edges)
             {
@@ -329,6 +456,7 @@ namespace ouzel
         {
             if (currentAnimator)
             {
+                sharedEngine->getAnimationManager()->removeAnimation(currentAnimator);
                 currentAnimator->parentNode = nullptr;
                 currentAnimator->stop();
             }
@@ -340,19 +468,18 @@ namespace ouzel
                 currentAnimator->removeFromParent();
                 currentAnimator->parentNode = this;
                 currentAnimator->start(this);
+                sharedEngine->getAnimationManager()->addAnimation(this, currentAnimator);
             }
-
-            sharedEngine->scheduleUpdate(&animationUpdateCallback);
         }
 
         void Node::removeAnimator(Animator* animator)
         {
             if (animator && animator == currentAnimator)
             {
+                sharedEngine->getAnimationManager()->removeAnimation(currentAnimator);
                 currentAnimator->parentNode = nullptr;
                 currentAnimator->stop();
                 currentAnimator = nullptr;
-                sharedEngine->unscheduleUpdate(&animationUpdateCallback);
             }
         }
 
@@ -360,10 +487,10 @@ namespace ouzel
         {
             if (currentAnimator)
             {
+                sharedEngine->getAnimationManager()->removeAnimation(currentAnimator);
                 currentAnimator->parentNode = nullptr;
                 currentAnimator->stop();
                 currentAnimator = nullptr;
-                sharedEngine->unscheduleUpdate(&animationUpdateCallback);
             }
         }
 
@@ -382,6 +509,99 @@ namespace ouzel
             localTransformDirty = false;
         }
 
+        const Matrix4& Node::getDrawTransform()
+        {
+            if (transformDirty)
+            {
+                calculateTransform();
+            }
+
+            if (!sharedEngine->isInterpolatingTransforms())
+            {
+                return transform;
+            }
+
+            if (drawTransformFrame != sharedEngine->getFrameCount())
+            {
+                calculateDrawTransform();
+            }
+
+            return drawTransformInterpolated ? drawTransform : transform;
+        }
+
+        void Node::calculateDrawTransform()
+        {
+            drawTransformFrame = sharedEngine->getFrameCount();
+
+            Node* parentNode = (parent && parentIsNode) ? static_cast<Node*>(parent) : nullptr;
+            const Matrix4& parentDrawTransform = parentNode ? parentNode->getDrawTransform() : parentTransform;
+            bool parentInterpolated = parentNode && parentNode->drawTransformInterpolated;
+
+            // nodes are not interpolated before they are drawn for the first time, the previous state would be the initial one
+            bool moved = drawn && previousStateStep == sharedEngine->getTimeStepCount();
+
+            if (!drawn)
+            {
+                previousPosition = position;
+                previousRotation = rotation;
+                previousScale = scale;
+                drawn = true;
+            }
+
+            drawTransformInterpolated = moved || parentInterpolated;
+
+            if (!drawTransformInterpolated)
+            {
+                return;
+            }
+
+            if (moved)
+            {
+                float alpha = sharedEngine->getInterpolationAlpha();
+
+                // take the shorter way around
+                Quaternion targetRotation = rotation;
+                if (previousRotation.v[0] * rotation.v[0] + previousRotation.v[1] * rotation.v[1] +
+                    previousRotation.v[2] * rotation.v[2] + previousRotation.v[3] * rotation.v[3] < 0.0f)
+                {
+                    targetRotation = rotation * -1.0f;
+                }
+
+                Quaternion currentRotation;
+                currentRotation.lerp(previousRotation, targetRotation, alpha);
+                currentRotation.normalize();
+
+                Vector3 currentScale = previousScale + (scale - previousScale) * alpha;
+
+                Matrix4 currentLocalTransform;
+                currentLocalTransform.setIdentity();
+                currentLocalTransform.translate(previousPosition + (position - previousPosition) * alpha);
+                currentLocalTransform *= currentRotation.getMatrix();
+                currentLocalTransform.scale(Vector3(currentScale.v[0] * (flipX ? -1.0f : 1.0f),
+                                                    currentScale.v[1] * (flipY ? -1.0f : 1.0f),
+                                                    currentScale.v[2]));
+
+                drawTransform = parentDrawTransform * currentLocalTransform;
+            }
+            else
+            {
+                drawTransform = parentDrawTransform * getLocalTransform();
+            }
+        }
+
+        void Node::savePreviousState()
+        {
+            uint32_t step = sharedEngine->getTimeStepCount();
+
+            if (previousStateStep != step)
+            {
+                previousPosition = position;
+                previousRotation = rotation;
+                previousScale = scale;
+                previousStateStep = step;
+            }
+        }
+
         void Node::calculateTransform() const
         {
             transform = parentTransform * getLocalTransform();
@@ -406,8 +626,15 @@ namespace ouzel
                 oldNode->removeComponent(component);
             }
 
+            if (component->levelOfDetail)
+            {
+                component->levelOfDetail->removeLevel(component);
+            }
+
             component->node = this;
             components.push_back(component);
+
+            nodeChanged(this);
         }
 
         bool Node::removeComponent(uint32_t index)
@@ -422,6 +649,8 @@ namespace ouzel
 
             components.erase(components.begin() + static_cast<int>(index));
 
+            nodeChanged(this);
+
             return true;
         }
 
@@ -433,6 +662,9 @@ namespace ouzel
                 {
                     component->node = nullptr;
                     components.erase(i);
+
+                    nodeChanged(this);
+
                     return true;
                 }
                 else
@@ -447,23 +679,118 @@ namespace ouzel
         void Node::removeAllComponents()
         {
             components.clear();
+
+            nodeChanged(this);
         }
 
-        void Node::updateAnimation(float delta)
+        bool Node::compareDrawOrder(Node* a, Node* b)
         {
-            if (currentAnimator)
+            return a->worldOrder > b->worldOrder ||
+                (a->worldOrder == b->worldOrder && a->drawIndex < b->drawIndex);
+        }
+
+        void Node::nodeChanged(Node* node)
+        {
+            // nodes inside of a static subtree are not in the draw queue, so the static root is reported instead
+            if (staticBatch)
+            {
+                staticBatchDirty = true;
+                node = this;
+            }
+
+            if (parent) parent->nodeChanged(node);
+        }
+
+        void Node::childrenChanged()
+        {
+            if (staticBatch)
+            {
+                staticBatchDirty = true;
+                if (parent) parent->nodeChanged(this);
+            }
+            else if (parent)
+            {
+                parent->childrenChanged();
+            }
+        }
+
+        void Node::updateDrawIndex(uint32_t& nextDrawIndex)
+        {
+            drawIndex = nextDrawIndex++;
+
+            for (Node* child : children)
+            {
+                child->updateDrawIndex(nextDrawIndex);
+            }
+        }
+
+        void Node::bakeStaticBatch()
+        {
+            FrameVector<std::pair<Node*, Matrix4>> nodes(sharedEngine->getFrameAllocator());
+            nodes.push_back(std::make_pair(this, Matrix4::IDENTITY));
+            updateStaticChildren(nodes, Matrix4::IDENTITY);
+
+            // same order as the nodes would have in the draw queue of the layer
+            std::stable_sort(nodes.begin(), nodes.end(),
+                             [](const std::pair<Node*, Matrix4>& a, const std::pair<Node*, Matrix4>& b) {
+                                 return a.first->worldOrder > b.first->worldOrder;
+                             });
+
+            staticBatch->clear();
+
+            for (const std::pair<Node*, Matrix4>& entry : nodes)
             {
-                currentAnimator->update(delta);
+                Node* node = entry.first;
+                Color drawColor(node->color.v[0], node->color.v[1], node->color.v[2], static_cast<uint8_t>(node->color.v[3] * node->opacity));
 
-                if (currentAnimator->isDone())
+                for (Component* component : node->components)
                 {
-                    removeCurrentAnimator();
-                    sharedEngine->unscheduleUpdate(&animationUpdateCallback);
+                    if (!component->isHidden() &&
+                        !component->bake(entry.second, drawColor, *staticBatch))
+                    {
+                        staticBatch->addComponent(component, entry.second, drawColor);
+                    }
                 }
             }
-            else
+
+            staticBatch->upload();
+            staticBatchDirty = false;
+        }
+
+        void Node::updateStaticChildren(FrameVector<std::pair<Node*, Matrix4>>& nodes,
+                                        const Matrix4& relativeTransform)
+        {
+            for (Node* child : children)
             {
-                sharedEngine->unscheduleUpdate(&animationUpdateCallback);
+                child->worldOrder = worldOrder + child->order;
+                child->worldHidden = worldHidden || child->hidden;
+                child->updateTransform(getTransform());
+
+                Matrix4 childRelativeTransform = relativeTransform * child->getLocalTransform();
+
+                if (!child->hidden)
+                {
+                    nodes.push_back(std::make_pair(child, childRelativeTransform));
+                    child->updateStaticChildren(nodes, childRelativeTransform);
+                }
+                else
+                {
+                    FrameVector<std::pair<Node*, Matrix4>> hiddenNodes(sharedEngine->getFrameAllocator());
+                    child->updateStaticChildren(hiddenNodes, childRelativeTransform);
+                }
+            }
+        }
+
+        void Node::markDrawQueueDirty()
+        {
+            drawQueueDirty = true;
+
+            if (!staticBatch)
+            {
+                for (Node* child : children)
+                {
+                    child->markDrawQueueDirty();
+                }
             }
         }
 
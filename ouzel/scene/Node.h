@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
+#include "core/FrameAllocator.h"
 #include "scene/NodeContainer.h"
 #include "math/AABB3.h"
 #include "math/Color.h"
@@ -11,27 +13,30 @@
 #include "math/Quaternion.h"
 #include "math/Vector2.h"
 #include "math/Vector3.h"
-#include "core/UpdateCallback.h"
 
 namespace ouzel
 {
     namespace scene
     {
+        class AnimationManager;
         class Animator;
         class Camera;
         class Component;
         class Layer;
+        class StaticBatch;
 
         class Node: public NodeContainer
         {
             friend NodeContainer;
             friend Layer;
+            friend AnimationManager;
             friend Animator;
+            friend Component;
         public:
             Node();
             virtual ~Node();
 
-            virtual void visit(std::vector<Node*>& drawQueue,
+            virtual void visit(FrameVector<Node*>& drawQueue,
                                const Matrix4& newParentTransform,
                                bool parentTransformDirty,
                                Camera* camera,
@@ -48,7 +53,7 @@ namespace ouzel
             virtual void setPosition(const Vector3& newPosition);
             virtual const Vector3& getPosition() const { return position; }
 
-            void setOrder(int32_t newOrder) { order = newOrder; }
+            void setOrder(int32_t newOrder);
             int32_t getOrder() const { return order; }
 
             virtual void setRotation(const Quaternion& newRotation);
@@ -76,14 +81,17 @@ namespace ouzel
             virtual bool isPickable() const { return pickable; }
 
             virtual bool isCullDisabled() const { return cullDisabled; }
-            virtual void setCullDisabled(bool newCullDisabled) { cullDisabled = newCullDisabled; }
+            virtual void setCullDisabled(bool newCullDisabled);
 
             virtual void setHidden(bool newHidden);
             virtual bool isHidden() const { return hidden; }
             bool isWorldHidden() const { return worldHidden; }
 
+            void setStatic(bool newStatic);
+            bool isStatic() const { return staticBatch != nullptr; }
+
             virtual bool pointOn(const Vector2& worldPosition) const;
-            virtual bool shapeOverlaps(const std::vector<Vector2>& edges) const;
+            virtual bool shapeOverlaps(const FrameVector<Vector2>& edges) const;
 
             const Matrix4& getLocalTransform() const
             {
@@ -117,8 +125,12 @@ namespace ouzel
 
             virtual void updateTransform(const Matrix4& newParentTransform);
 
+            // the transform used for drawing, blended between the last two fixed time steps when the engine interpolates transforms
+            const Matrix4& getDrawTransform();
+
             Vector3 getWorldPosition() const;
             virtual int32_t getWorldOrder() const { return worldOrder; }
+            uint32_t getDrawIndex() const { return drawIndex; }
 
             Vector3 convertWorldToLocal(const Vector3& worldPosition) const;
             Vector3 convertLocalToWorld(const Vector3& localPosition) const;
@@ -140,10 +152,20 @@ namespace ouzel
 
             virtual void calculateLocalTransform() const;
             virtual void calculateTransform() const;
+            void calculateDrawTransform();
+            void savePreviousState();
 
             virtual void calculateInverseTransform() const;
 
-            void updateAnimation(float delta);
+            static bool compareDrawOrder(Node* a, Node* b);
+
+            virtual void nodeChanged(Node* node) override;
+            virtual void childrenChanged() override;
+            void updateDrawIndex(uint32_t& nextDrawIndex);
+            void markDrawQueueDirty();
+            void bakeStaticBatch();
+            void updateStaticChildren(FrameVector<std::pair<Node*, Matrix4>>& nodes,
+                                      const Matrix4& relativeTransform);
 
             Matrix4 parentTransform;
             mutable Matrix4 transform;
@@ -162,6 +184,8 @@ namespace ouzel
             bool cullDisabled = false;
             bool hidden = false;
             bool worldHidden = false;
+            bool staticBatchDirty = false;
+            bool drawQueueDirty = false;
 
             Vector3 position;
             Quaternion rotation = Quaternion::IDENTITY;
@@ -170,13 +194,25 @@ namespace ouzel
             float opacity = 1.0f;
             int32_t order = 0;
             int32_t worldOrder = 0;
+            uint32_t drawIndex = 0;
+
+            // state at the beginning of the fixed time step in which the node was last moved
+            Vector3 previousPosition;
+            Quaternion previousRotation = Quaternion::IDENTITY;
+            Vector3 previousScale = Vector3(1.0f, 1.0f, 1.0f);
+            uint32_t previousStateStep = 0;
+            uint32_t drawTransformFrame = 0;
+            bool drawTransformInterpolated = false;
+            bool drawn = false;
+            Matrix4 drawTransform;
 
             Animator* currentAnimator = nullptr;
             std::vector<Component*> components;
 
             NodeContainer* parent = nullptr;
+            bool parentIsNode = false;
 
-            UpdateCallback animationUpdateCallback;
+            std::unique_ptr<StaticBatch> staticBatch;
         };
     } // namespace scene
 } // namespace ouzel
@@ -35,6 +35,8 @@ namespace ouzel
                 node->parent = this;
                 if (entered) node->enter();
                 children.push_back(node);
+
+                childrenChanged();
             }
         }
 
@@ -48,6 +50,8 @@ namespace ouzel
                 node->parent = nullptr;
                 children.erase(i);
 
+                childrenChanged();
+
                 return true;
             }
             else
@@ -67,6 +71,8 @@ namespace ouzel
             }
 
             children.clear();
+
+            childrenChanged();
         }
 
         bool NodeContainer::hasChild(Node* node, bool recursive) const
@@ -104,7 +110,7 @@ namespace ouzel
             }
         }
 
-        void NodeContainer::findNodes(const Vector2& position, std::vector<Node*>& nodes) const
+        void NodeContainer::findNodes(const Vector2& position, FrameVector<Node*>& nodes) const
         {
             for (auto i = children.rbegin(); i != children.rend(); ++i)
             {
@@ -127,7 +133,7 @@ namespace ouzel
             }
         }
 
-        void NodeContainer::findNodes(const std::vector<Vector2>& edges, std::vector<Node*>& nodes) const
+        void NodeContainer::findNodes(const FrameVector<Vector2>& edges, FrameVector<Node*>& nodes) const
         {
             for (auto i = children.rbegin(); i != children.rend(); ++i)
             {
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <vector>
+#include "core/FrameAllocator.h"
 #include "utils/Noncopyable.h"
 #include "math/Vector2.h"
 
@@ -15,6 +16,7 @@ namespace ouzel
 
         class NodeContainer: public Noncopyable
         {
+            friend Node;
         public:
             NodeContainer();
             virtual ~NodeContainer();
@@ -26,12 +28,15 @@ namespace ouzel
             virtual const std::vector<Node*>& getChildren() const { return children; }
 
         protected:
-            void findNodes(const Vector2& position, std::vector<Node*>& nodes) const;
-            void findNodes(const std::vector<Vector2>& edges, std::vector<Node*>& nodes) const;
+            void findNodes(const Vector2& position, FrameVector<Node*>& nodes) const;
+            void findNodes(const FrameVector<Vector2>& edges, FrameVector<Node*>& nodes) const;
 
             virtual void enter();
             virtual void leave();
 
+            virtual void nodeChanged(Node*) {}
+            virtual void childrenChanged() {}
+
             std::vector<Node*> children;
             bool entered = false;
         };
@@ -0,0 +1,190 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <utility>
+#include "ParticleManager.h"
+#include "ParticleSystem.h"
+#include "core/Engine.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        ParticleManager::ParticleManager()
+        {
+            updateCallback.callback = std::bind(&ParticleManager::update, this, std::placeholders::_1);
+        }
+
+        ParticleManager::~ParticleManager()
+        {
+            if (scheduled && sharedEngine) sharedEngine->unscheduleUpdate(&updateCallback);
+        }
+
+        void ParticleManager::addParticleSystem(ParticleSystem* particleSystem)
+        {
+            if (std::find(particleSystems.begin(), particleSystems.end(), particleSystem) == particleSystems.end())
+            {
+                particleSystems.push_back(particleSystem);
+            }
+
+            if (!scheduled)
+            {
+                sharedEngine->scheduleUpdate(&updateCallback);
+                scheduled = true;
+            }
+        }
+
+        void ParticleManager::removeParticleSystem(ParticleSystem* particleSystem)
+        {
+            // entries are only cleared here, because this can be called from the update loop
+            std::replace(particleSystems.begin(), particleSystems.end(), particleSystem, static_cast<ParticleSystem*>(nullptr));
+            std::replace(updatedSystems.begin(), updatedSystems.end(), particleSystem, static_cast<ParticleSystem*>(nullptr));
+
+            chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [particleSystem](const Chunk& chunk) {
+                return chunk.particleSystem == particleSystem;
+            }), chunks.end());
+        }
+
+        void ParticleManager::update(float delta)
+        {
+            updateDelta = delta;
+            updatedSystems.clear();
+
+            // emission bookkeeping and node transforms are read on the update thread
+            for (uint32_t i = 0; i < particleSystems.size(); ++i)
+            {
+                ParticleSystem* particleSystem = particleSystems[i];
+
+                if (particleSystem && particleSystem->beginUpdate(delta))
+                {
+                    updatedSystems.push_back(particleSystem);
+                }
+            }
+
+            particleSystems.erase(std::remove(particleSystems.begin(), particleSystems.end(), static_cast<ParticleSystem*>(nullptr)), particleSystems.end());
+            updatedSystems.erase(std::remove(updatedSystems.begin(), updatedSystems.end(), static_cast<ParticleSystem*>(nullptr)), updatedSystems.end());
+
+            applyBudget();
+
+            if (updatedSystems.empty())
+            {
+                return;
+            }
+
+            JobSystem* jobSystem = sharedEngine->getJobSystem();
+
+            jobSystem->parallelFor(static_cast<uint32_t>(updatedSystems.size()), [this](uint32_t index) {
+                updatedSystems[index]->emitPendingParticles();
+            });
+
+            chunks.clear();
+
+            for (ParticleSystem* particleSystem : updatedSystems)
+            {
+                uint32_t count = particleSystem->particleCount;
+
+                for (uint32_t first = 0; first < count; first += chunkSize)
+                {
+                    chunks.push_back({particleSystem, first, std::min(chunkSize, count - first)});
+                }
+            }
+
+            jobSystem->parallelFor(static_cast<uint32_t>(chunks.size()), [this](uint32_t index) {
+                const Chunk& chunk = chunks[index];
+                chunk.particleSystem->simulateParticles(updateDelta, chunk.first, chunk.count);
+            });
+
+            jobSystem->parallelFor(static_cast<uint32_t>(updatedSystems.size()), [this](uint32_t index) {
+                updatedSystems[index]->finishSimulation();
+            });
+
+            for (ParticleSystem* particleSystem : updatedSystems)
+            {
+                if (particleSystem) particleSystem->endUpdate();
+            }
+        }
+
+        void ParticleManager::applyBudget()
+        {
+            liveParticleCount = 0;
+            fillEstimate = 0.0f;
+            requestedParticleCount = 0;
+            droppedParticleCount = 0;
+            throttledSystemCount = 0;
+            skippedSystemCount = 0;
+
+            for (ParticleSystem* particleSystem : particleSystems)
+            {
+                liveParticleCount += particleSystem->particleCount;
+                fillEstimate += particleSystem->fillEstimate;
+            }
+
+            budgetOrder.clear();
+
+            for (ParticleSystem* particleSystem : updatedSystems)
+            {
+                if (particleSystem->pendingEmitCount)
+                {
+                    requestedParticleCount += particleSystem->pendingEmitCount;
+
+                    float distance = particleSystem->worldPosition.distance(focusPosition);
+                    float score = static_cast<float>(particleSystem->priority) / (1.0f + distance / distanceFalloff);
+                    budgetOrder.push_back(std::make_pair(score, particleSystem));
+                }
+            }
+
+            if (!particleBudget && fillBudget <= 0.0f)
+            {
+                return;
+            }
+
+            // stable, so that systems with equal scores are served in the same order every time
+            std::stable_sort(budgetOrder.begin(), budgetOrder.end(), [](const std::pair<float, ParticleSystem*>& a,
+                                                                        const std::pair<float, ParticleSystem*>& b) {
+                return a.first > b.first;
+            });
+
+            uint32_t remainingParticles = (particleBudget > liveParticleCount) ? particleBudget - liveParticleCount : 0;
+            float remainingFill = std::max(fillBudget - fillEstimate, 0.0f);
+
+            for (const std::pair<float, ParticleSystem*>& entry : budgetOrder)
+            {
+                ParticleSystem* particleSystem = entry.second;
+                uint32_t requested = particleSystem->pendingEmitCount;
+                uint32_t allowed = requested;
+
+                if (particleBudget)
+                {
+                    allowed = std::min(allowed, remainingParticles);
+                }
+
+                float particleFill = 0.0f;
+
+                if (fillBudget > 0.0f)
+                {
+                    particleFill = particleSystem->getAverageParticleFill();
+
+                    if (particleFill > 0.0f)
+                    {
+                        // clamped as float, the quotient can exceed the range of uint32_t
+                        float fillCount = std::min(remainingFill / particleFill, static_cast<float>(allowed));
+                        allowed = static_cast<uint32_t>(fillCount);
+                    }
+                }
+
+                if (particleBudget) remainingParticles -= allowed;
+                if (particleFill > 0.0f) remainingFill = std::max(remainingFill - allowed * particleFill, 0.0f);
+
+                if (allowed < requested)
+                {
+                    if (allowed) ++throttledSystemCount;
+                    else ++skippedSystemCount;
+
+                    droppedParticleCount += requested - allowed;
+                    particleSystem->pendingEmitCount = allowed;
+                }
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
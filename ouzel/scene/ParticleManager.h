@@ -0,0 +1,97 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "utils/Noncopyable.h"
+#include "core/UpdateCallback.h"
+#include "math/Vector2.h"
+
+namespace ouzel
+{
+    class Engine;
+
+    namespace scene
+    {
+        class ParticleSystem;
+
+        // Updates all active particle systems once per frame.
+        // Emission, simulation and mesh generation of different systems (and of chunks of large systems)
+        // run as jobs of the engine's JobSystem. Every system has its own random generator, so the result does not depend on scheduling.
+        class ParticleManager: public Noncopyable
+        {
+            friend Engine;
+        public:
+            virtual ~ParticleManager();
+
+            void addParticleSystem(ParticleSystem* particleSystem);
+            void removeParticleSystem(ParticleSystem* particleSystem);
+
+            uint32_t getParticleSystemCount() const { return static_cast<uint32_t>(particleSystems.size()); }
+
+            // number of particles simulated by one job
+            void setChunkSize(uint32_t newChunkSize) { chunkSize = (newChunkSize + 3) & ~3U; if (!chunkSize) chunkSize = 4; }
+            uint32_t getChunkSize() const { return chunkSize; }
+
+            // limits the total number of live particles, 0 means no limit
+            void setParticleBudget(uint32_t newParticleBudget) { particleBudget = newParticleBudget; }
+            uint32_t getParticleBudget() const { return particleBudget; }
+
+            // limits the total particle area (sum of squared particle sizes), 0 means no limit
+            void setFillBudget(float newFillBudget) { fillBudget = newFillBudget; }
+            float getFillBudget() const { return fillBudget; }
+
+            // when over budget, emission is given to systems with higher priority and closer to the focus position first
+            void setFocusPosition(const Vector2& newFocusPosition) { focusPosition = newFocusPosition; }
+            const Vector2& getFocusPosition() const { return focusPosition; }
+            // distance at which the priority of a system is halved
+            void setDistanceFalloff(float newDistanceFalloff) { distanceFalloff = newDistanceFalloff; }
+            float getDistanceFalloff() const { return distanceFalloff; }
+
+            uint32_t getLiveParticleCount() const { return liveParticleCount; }
+            float getFillEstimate() const { return fillEstimate; }
+            uint32_t getRequestedParticleCount() const { return requestedParticleCount; }
+            uint32_t getDroppedParticleCount() const { return droppedParticleCount; }
+            uint32_t getThrottledSystemCount() const { return throttledSystemCount; }
+            uint32_t getSkippedSystemCount() const { return skippedSystemCount; }
+
+        protected:
+            ParticleManager();
+
+            void update(float delta);
+            void applyBudget();
+
+            struct Chunk
+            {
+                ParticleSystem* particleSystem;
+                uint32_t first;
+                uint32_t count;
+            };
+
+            std::vector<ParticleSystem*> particleSystems;
+            std::vector<ParticleSystem*> updatedSystems;
+            std::vector<Chunk> chunks;
+            uint32_t chunkSize = 4096;
+            float updateDelta = 0.0f;
+
+            uint32_t particleBudget = 0;
+            float fillBudget = 0.0f;
+            Vector2 focusPosition;
+            float distanceFalloff = 1000.0f;
+            std::vector<std::pair<float, ParticleSystem*>> budgetOrder;
+
+            uint32_t liveParticleCount = 0;
+            float fillEstimate = 0.0f;
+            uint32_t requestedParticleCount = 0;
+            uint32_t droppedParticleCount = 0;
+            uint32_t throttledSystemCount = 0;
+            uint32_t skippedSystemCount = 0;
+
+            UpdateCallback updateCallback;
+            bool scheduled = false;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -1,8 +1,14 @@
 // Copyright (C) 2017 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
 #include <cstdlib>
 #include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#endif
 #include "ParticleSystem.h"
 #include "core/Engine.h"
 #include "SceneManager.h"
@@ -12,6 +18,7 @@
 #include "scene/Camera.h"
 #include "graphics/MeshBufferResource.h"
 #include "graphics/BufferResource.h"
+#include "utils/MemoryTracker.h"
 #include "utils/Utils.h"
 #include "math/MathUtils.h"
 
@@ -19,13 +26,149 @@ namespace ouzel
 {
     namespace scene
     {
+        // values += deltas * delta, deltas can be null to add delta to every value
+        static void addScaled(float* values, const float* deltas, float delta, uint32_t count, bool clampToZero = false)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                float32x4_t d = vdupq_n_f32(delta);
+                float32x4_t zero = vdupq_n_f32(0.0f);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    float32x4_t result = deltas ? vmlaq_f32(vld1q_f32(values + i), vld1q_f32(deltas + i), d) : vaddq_f32(vld1q_f32(values + i), d);
+                    if (clampToZero) result = vmaxq_f32(result, zero);
+                    vst1q_f32(values + i, result);
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 d = _mm_set1_ps(delta);
+            __m128 zero = _mm_setzero_ps();
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 result = _mm_add_ps(_mm_loadu_ps(values + i), deltas ? _mm_mul_ps(_mm_loadu_ps(deltas + i), d) : d);
+                if (clampToZero) result = _mm_max_ps(result, zero);
+                _mm_storeu_ps(values + i, result);
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                values[i] += deltas ? deltas[i] * delta : delta;
+                if (clampToZero) values[i] = std::max(0.0f, values[i]);
+            }
+        }
+
+        // checks four consecutive life values
+        static inline bool hasDeadParticles(const float* life)
+        {
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                uint32x4_t dead = vcltq_f32(vld1q_f32(life), vdupq_n_f32(0.0f));
+                uint32x2_t combined = vorr_u32(vget_low_u32(dead), vget_high_u32(dead));
+                return (vget_lane_u32(combined, 0) | vget_lane_u32(combined, 1)) != 0;
+            }
+#elif OUZEL_SUPPORTS_SSE
+            return _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(life), _mm_setzero_ps())) != 0;
+#endif
+
+#if (!OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON64 && !OUZEL_SUPPORTS_SSE) || OUZEL_SUPPORTS_NEON_CHECK
+            return life[0] < 0.0f || life[1] < 0.0f || life[2] < 0.0f || life[3] < 0.0f;
+#endif
+        }
+
+        static void emitColors(float* color, float* deltaColor, const float* life, uint32_t count,
+                               float start, float startVariance, float finish, float finishVariance,
+                               const float* randomValues)
+        {
+            const float* startValues = randomValues;
+            const float* finishValues = randomValues + count;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                color[i] = clamp(start + startVariance * startValues[i], 0.0f, 1.0f);
+                deltaColor[i] = (clamp(finish + finishVariance * finishValues[i], 0.0f, 1.0f) - color[i]) / life[i];
+            }
+        }
+
+        static void getParticleBounds(const float* positionX, const float* positionY, uint32_t count,
+                                      Vector2& minPosition, Vector2& maxPosition)
+        {
+            float minX = positionX[0];
+            float minY = positionY[0];
+            float maxX = positionX[0];
+            float maxY = positionY[0];
+
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+            if (count >= 4)
+            {
+                __m128 minXs = _mm_loadu_ps(positionX);
+                __m128 minYs = _mm_loadu_ps(positionY);
+                __m128 maxXs = minXs;
+                __m128 maxYs = minYs;
+
+                for (i = 4; i + 4 <= count; i += 4)
+                {
+                    __m128 x = _mm_loadu_ps(positionX + i);
+                    __m128 y = _mm_loadu_ps(positionY + i);
+                    minXs = _mm_min_ps(minXs, x);
+                    minYs = _mm_min_ps(minYs, y);
+                    maxXs = _mm_max_ps(maxXs, x);
+                    maxYs = _mm_max_ps(maxYs, y);
+                }
+
+                float values[4];
+                _mm_storeu_ps(values, minXs);
+                minX = std::min(std::min(values[0], values[1]), std::min(values[2], values[3]));
+                _mm_storeu_ps(values, minYs);
+                minY = std::min(std::min(values[0], values[1]), std::min(values[2], values[3]));
+                _mm_storeu_ps(values, maxXs);
+                maxX = std::max(std::max(values[0], values[1]), std::max(values[2], values[3]));
+                _mm_storeu_ps(values, maxYs);
+                maxY = std::max(std::max(values[0], values[1]), std::max(values[2], values[3]));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                minX = std::min(minX, positionX[i]);
+                minY = std::min(minY, positionY[i]);
+                maxX = std::max(maxX, positionX[i]);
+                maxY = std::max(maxY, positionY[i]);
+            }
+
+            minPosition.set(minX, minY);
+            maxPosition.set(maxX, maxY);
+        }
+
         ParticleSystem::ParticleSystem()
         {
             shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
             blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
             whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
 
-            updateCallback.callback = std::bind(&ParticleSystem::update, this, std::placeholders::_1);
+            random.setSeed((static_cast<uint64_t>(randomEngine.getUInt32()) << 32) | randomEngine.getUInt32());
+
+        }
+
+        ParticleSystem::~ParticleSystem()
+        {
+            if (preWarmPending) sharedEngine->getJobSystem()->wait(preWarmCounter);
+
+            if (active) sharedEngine->getParticleManager()->removeParticleSystem(this);
+
+            MemoryTracker::update(MemoryTracker::Tag::SCENE, memorySize, 0);
         }
 
         ParticleSystem::ParticleSystem(const std::string& filename):
@@ -40,12 +183,25 @@ namespace ouzel
         {
             Component::draw(transformMatrix, drawColor, camera);
 
+            timeSinceDraw = 0.0f;
+
+            if (sleeping)
+            {
+                wakeRequested = true;
+                return;
+            }
+
+            if (preWarmPending)
+            {
+                return;
+            }
+
             if (particleCount)
             {
-                if (needsMeshUpdate)
+                if (needsMeshUpload)
                 {
-                    updateParticleMesh();
-                    needsMeshUpdate = false;
+                    vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+                    needsMeshUpload = false;
                 }
 
                 Matrix4 transform;
@@ -62,11 +218,13 @@ namespace ouzel
 
                 float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
 
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+                FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+                FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
 
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(transform.m), std::end(transform.m)};
+                FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                vertexShaderConstants.emplace_back(std::begin(transform.m), std::end(transform.m), frameAllocator);
 
                 sharedEngine->getRenderer()->addDrawCommand({texture},
                                                             shader,
@@ -90,8 +248,19 @@ namespace ouzel
         {
             Component::drawWireframe(transformMatrix, drawColor, camera);
 
+            if (preWarmPending)
+            {
+                return;
+            }
+
             if (particleCount)
             {
+                if (needsMeshUpload)
+                {
+                    vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+                    needsMeshUpload = false;
+                }
+
                 Matrix4 transform;
 
                 if (particleDefinition.positionType == ParticleDefinition::PositionType::FREE ||
@@ -106,11 +275,13 @@ namespace ouzel
 
                 float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
 
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+                FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+                FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
 
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(transform.m), std::end(transform.m)};
+                FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                vertexShaderConstants.emplace_back(std::begin(transform.m), std::end(transform.m), frameAllocator);
 
                 sharedEngine->getRenderer()->addDrawCommand({whitePixelTexture},
                                                             shader,
@@ -131,6 +302,129 @@ namespace ouzel
 
         void ParticleSystem::update(float delta)
         {
+            if (beginUpdate(delta))
+            {
+                emitPendingParticles();
+                simulateParticles(delta, 0, particleCount);
+                finishSimulation();
+                endUpdate();
+            }
+        }
+
+        bool ParticleSystem::beginUpdate(float delta)
+        {
+            pendingEmitCount = 0;
+
+            if (preWarmPending)
+            {
+                if (!preWarmCounter.isDone()) return false;
+
+                finishPreWarm();
+            }
+
+            if (preWarmTime > 0.0f && active && node)
+            {
+                float duration = preWarmTime;
+                preWarmTime = 0.0f;
+
+                updateNodeState();
+
+#if OUZEL_MULTITHREADED
+                if (preWarmAsync)
+                {
+                    preWarmPending = true;
+                    sharedEngine->getJobSystem()->run([this, duration]() {
+                        fastForwardSimulation(duration, preWarmStep);
+                        finishSimulation();
+                    }, &preWarmCounter);
+
+                    return false;
+                }
+#endif
+
+                fastForwardSimulation(duration, preWarmStep);
+            }
+
+            if (sleeping)
+            {
+                if (!wakeRequested)
+                {
+                    sleepTime += delta;
+                    return false;
+                }
+
+                // catch up with the time spent off-screen
+                updateNodeState();
+                fastForwardSimulation(sleepTime, fastForwardStep);
+
+                sleeping = false;
+                wakeRequested = false;
+                sleepTime = 0.0f;
+                timeSinceDraw = 0.0f;
+            }
+            else if (sleepWhenHidden && running && timeSinceDraw > sleepDelay && !sleepBoundingBox.isEmpty())
+            {
+                sleeping = true;
+                sleepTime = delta;
+
+                // the extents seen so far are used for culling, so that the system is woken up when it gets visible
+                boundingBox = sleepBoundingBox;
+                invalidateNode();
+
+                return false;
+            }
+
+            timeSinceDraw += delta;
+
+            uint32_t emitCount = updateEmission(delta);
+            if (node) pendingEmitCount = emitCount;
+
+            if (!(running && particleDefinition.emissionRate > 0.0f) && active && !particleCount)
+            {
+                active = false;
+                sharedEngine->getParticleManager()->removeParticleSystem(this);
+                if (finishHandler) finishHandler();
+                return false;
+            }
+
+            if (!active || (!particleCount && !pendingEmitCount && boundingBox.isEmpty()))
+            {
+                return false;
+            }
+
+            // node state is read here, the rest of the update can run on a worker thread
+            updateNodeState();
+
+            return true;
+        }
+
+        void ParticleSystem::updateNodeState()
+        {
+            if (node)
+            {
+                if (particleDefinition.positionType == ParticleDefinition::PositionType::FREE)
+                {
+                    emitterPosition = node->convertLocalToWorld(Vector2::ZERO);
+                }
+                else if (particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
+                {
+                    emitterPosition = node->convertLocalToWorld(Vector2::ZERO) - node->getPosition();
+                }
+                else
+                {
+                    emitterPosition = Vector2();
+                }
+
+                worldPosition = node->convertLocalToWorld(Vector2::ZERO);
+                parentOffset = node->getPosition();
+                inverseTransform = node->getInverseTransform();
+            }
+        }
+
+        uint32_t ParticleSystem::updateEmission(float delta)
+        {
+            uint32_t emitCount = 0;
+
             if (running && particleDefinition.emissionRate > 0.0f)
             {
                 float rate = 1.0f / particleDefinition.emissionRate;
@@ -142,8 +436,7 @@ namespace ouzel
                         emitCounter = 0.f;
                 }
 
-                uint32_t emitCount = static_cast<uint32_t>(std::min(static_cast<float>(particleDefinition.maxParticles - particleCount), emitCounter / rate));
-                emitParticles(emitCount);
+                emitCount = static_cast<uint32_t>(std::min(static_cast<float>(particleDefinition.maxParticles - particleCount), emitCounter / rate));
                 emitCounter -= rate * emitCount;
 
                 elapsed += delta;
@@ -152,123 +445,138 @@ namespace ouzel
                 if (particleDefinition.duration >= 0.0f && particleDefinition.duration < elapsed)
                 {
                     finished = true;
-                    stop();
+                    running = false;
                 }
             }
-            else if (active && !particleCount)
+
+            return emitCount;
+        }
+
+        void ParticleSystem::preWarm(float duration, float step, bool async)
+        {
+            finishPreWarm();
+
+            preWarmTime = duration;
+            preWarmStep = step;
+            preWarmAsync = async;
+        }
+
+        void ParticleSystem::fastForward(float duration, float step)
+        {
+            finishPreWarm();
+            fastForwardSimulation(duration, step);
+        }
+
+        void ParticleSystem::fastForwardSimulation(float duration, float step)
+        {
+            if (step <= 0.0f || duration <= 0.0f)
             {
-                active = false;
-                sharedEngine->unscheduleUpdate(&updateCallback);
-                if (finishHandler) finishHandler();
                 return;
             }
 
-            if (active)
+            if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
             {
-                for (uint32_t counter = particleCount; counter > 0; --counter)
+                // no particle outlives the longest lifespan, so only the last one has to be simulated
+                float lifespan = particleDefinition.particleLifespan + fabsf(particleDefinition.particleLifespanVariance);
+
+                if (duration > lifespan + step)
                 {
-                    size_t i = counter - 1;
+                    float skipped = duration - lifespan - step;
 
-                    particles[i].life -= delta;
+                    particleCount = 0;
+                    updateEmission(skipped);
+                    emitCounter = 0.0f;
+                    duration -= skipped;
+                }
+            }
 
-                    if (particles[i].life >= 0.0f)
-                    {
-                        if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
-                        {
-                            Vector2 tmp, radial, tangential;
-
-                            // radial acceleration
-                            if (particles[i].position.v[0] == 0.0f || particles[i].position.v[1] == 0.0f)
-                            {
-                                radial = particles[i].position;
-                                radial.normalize();
-                            }
-                            tangential = radial;
-                            radial *= particles[i].radialAcceleration;
-
-                            // tangential acceleration
-                            std::swap(tangential.v[0], tangential.v[1]);
-                            tangential.v[0] *= - particles[i].tangentialAcceleration;
-                            tangential.v[1] *= particles[i].tangentialAcceleration;
-
-                            // (gravity + radial + tangential) * delta
-                            tmp.v[0] = radial.v[0] + tangential.v[0] + particleDefinition.gravity.v[0];
-                            tmp.v[1] = radial.v[1] + tangential.v[1] + particleDefinition.gravity.v[1];
-                            tmp.v[0] *= delta;
-                            tmp.v[1] *= delta;
-
-                            particles[i].direction.v[0] += tmp.v[0];
-                            particles[i].direction.v[1] += tmp.v[1];
-
-                            // this is cocos2d-x v3.0
-                            // if (configName.length()>0 && yCoordFlipped != -1)
-
-                            // this is cocos2d-x v3.0
-                            tmp.v[0] = particles[i].direction.v[0] * delta * particleDefinition.yCoordFlipped;
-                            tmp.v[1] = particles[i].direction.v[1] * delta * particleDefinition.yCoordFlipped;
-                            particles[i].position.v[0] += tmp.v[0];
-                            particles[i].position.v[1] += tmp.v[1];
-                        }
-                        else
-                        {
-                            particles[i].angle += particles[i].degreesPerSecond * delta;
-                            particles[i].radius += particles[i].deltaRadius * delta;
-                            particles[i].position.v[0] = -cosf(particles[i].angle) * particles[i].radius;
-                            particles[i].position.v[1] = -sinf(particles[i].angle) * particles[i].radius * particleDefinition.yCoordFlipped;
-                        }
+            for (float time = 0.0f; time < duration; time += step)
+            {
+                float delta = std::min(step, duration - time);
+
+                emitParticles(updateEmission(delta));
+                simulateParticles(delta, 0, particleCount);
+                removeDeadParticles();
+            }
+        }
 
-                        //color r,g,b,a
-                        particles[i].colorRed += particles[i].deltaColorRed * delta;
-                        particles[i].colorGreen += particles[i].deltaColorGreen * delta;
-                        particles[i].colorBlue += particles[i].deltaColorBlue * delta;
-                        particles[i].colorAlpha += particles[i].deltaColorAlpha * delta;
+        void ParticleSystem::emitPendingParticles()
+        {
+            emitParticles(pendingEmitCount);
+            pendingEmitCount = 0;
+        }
 
-                        //size
-                        particles[i].size += (particles[i].deltaSize * delta);
-                        particles[i].size = std::max(0.0f, particles[i].size);
+        void ParticleSystem::simulateParticles(float delta, uint32_t first, uint32_t count)
+        {
+            if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
+            {
+                updateGravityParticles(delta, first, count);
+            }
+            else
+            {
+                updateRadiusParticles(delta, first, count);
+            }
 
-                        //angle
-                        particles[i].rotation += particles[i].deltaRotation * delta;
-                    }
-                    else
-                    {
-                        particles[i] = particles[particleCount - 1];
-                        particleCount--;
-                    }
+            updateParticleColors(delta, first, count);
+        }
+
+        void ParticleSystem::finishSimulation()
+        {
+            removeDeadParticles();
+
+            if (particleCount)
+            {
+                getParticleBounds(getStream(POSITION_X), getStream(POSITION_Y), particleCount, minPosition, maxPosition);
+
+                if (node)
+                {
+                    buildParticleMesh();
                 }
+            }
+        }
 
-                // Update bounding box
-                boundingBox.reset();
+        void ParticleSystem::endUpdate()
+        {
+            boundingBox.reset();
 
+            if (particleCount)
+            {
                 if (particleDefinition.positionType == ParticleDefinition::PositionType::FREE ||
                     particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
                 {
                     if (node)
                     {
-                        const Matrix4& inverseTransform = node->getInverseTransform();
-
-                        for (uint32_t i = 0; i < particleCount; i++)
+                        Vector3 corners[4] = {
+                            Vector3(minPosition.v[0], minPosition.v[1], 0.0f),
+                            Vector3(maxPosition.v[0], minPosition.v[1], 0.0f),
+                            Vector3(minPosition.v[0], maxPosition.v[1], 0.0f),
+                            Vector3(maxPosition.v[0], maxPosition.v[1], 0.0f)
+                        };
+
+                        for (Vector3& corner : corners)
                         {
-                            Vector3 position = particles[i].position;
-                            inverseTransform.transformPoint(position);
-                            boundingBox.insertPoint(Vector2(position.v[0], position.v[1]));
+                            inverseTransform.transformPoint(corner);
+                            boundingBox.insertPoint(Vector2(corner.v[0], corner.v[1]));
                         }
                     }
                 }
                 else if (particleDefinition.positionType == ParticleDefinition::PositionType::GROUPED)
                 {
-                    for (uint32_t i = 0; i < particleCount; i++)
-                    {
-                        boundingBox.insertPoint(particles[i].position);
-                    }
+                    boundingBox.insertPoint(minPosition);
+                    boundingBox.insertPoint(maxPosition);
                 }
-
-                needsMeshUpdate = true;
             }
+
+            sleepBoundingBox.merge(boundingBox);
+            needsMeshUpload = true;
+
+            invalidateNode();
         }
 
         bool ParticleSystem::initFromParticleDefinition(const ParticleDefinition& newParticleDefinition)
         {
+            finishPreWarm();
+
             particleDefinition = newParticleDefinition;
 
             texture = sharedEngine->getCache()->getTexture(particleDefinition.textureFilename);
@@ -286,6 +594,8 @@ namespace ouzel
 
         bool ParticleSystem::initFromFile(const std::string& filename)
         {
+            finishPreWarm();
+
             particleDefinition = sharedEngine->getCache()->getParticleDefinition(filename);
 
             texture = sharedEngine->getCache()->getTexture(particleDefinition.textureFilename);
@@ -303,6 +613,8 @@ namespace ouzel
 
         void ParticleSystem::resume()
         {
+            finishPreWarm();
+
             if (!running)
             {
                 finished = false;
@@ -311,115 +623,159 @@ namespace ouzel
                 if (!active)
                 {
                     active = true;
-                    sharedEngine->scheduleUpdate(&updateCallback);
+                    sharedEngine->getParticleManager()->addParticleSystem(this);
                 }
             }
         }
 
         void ParticleSystem::stop()
         {
+            finishPreWarm();
+
             running = false;
         }
 
         void ParticleSystem::reset()
         {
+            finishPreWarm();
+
             emitCounter = 0.0f;
             elapsed = 0.0f;
             particleCount = 0;
             finished = false;
+            random.setSeed(random.getSeed());
+        }
+
+        void ParticleSystem::finishPreWarm()
+        {
+            if (preWarmPending)
+            {
+                sharedEngine->getJobSystem()->wait(preWarmCounter);
+                preWarmPending = false;
+                endUpdate();
+            }
         }
 
         bool ParticleSystem::createParticleMesh()
         {
+            indices.clear();
             indices.reserve(particleDefinition.maxParticles * 6);
-            vertices.reserve(particleDefinition.maxParticles * 4);
 
-            for (uint16_t i = 0; i < particleDefinition.maxParticles; ++i)
+            for (uint32_t i = 0; i < particleDefinition.maxParticles; ++i)
             {
-                indices.push_back(i * 4 + 0);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 2);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 3);
-                indices.push_back(i * 4 + 2);
-
-                vertices.push_back(graphics::VertexPCT(Vector3(-1.0f, -1.0f, 0.0f), Color::WHITE, Vector2(0.0f, 1.0f)));
-                vertices.push_back(graphics::VertexPCT(Vector3(1.0f, -1.0f, 0.0f), Color::WHITE, Vector2(1.0f, 1.0f)));
-                vertices.push_back(graphics::VertexPCT(Vector3(-1.0f, 1.0f, 0.0f),  Color::WHITE, Vector2(0.0f, 0.0f)));
-                vertices.push_back(graphics::VertexPCT(Vector3(1.0f, 1.0f, 0.0f),  Color::WHITE, Vector2(1.0f, 0.0f)));
+                indices.push_back(static_cast<uint16_t>(i * 4 + 0));
+                indices.push_back(static_cast<uint16_t>(i * 4 + 1));
+                indices.push_back(static_cast<uint16_t>(i * 4 + 2));
+                indices.push_back(static_cast<uint16_t>(i * 4 + 1));
+                indices.push_back(static_cast<uint16_t>(i * 4 + 3));
+                indices.push_back(static_cast<uint16_t>(i * 4 + 2));
             }
 
+            // vertices are written only for live particles, the buffer grows as needed
+            vertices.clear();
+            vertices.reserve(particleDefinition.maxParticles * 4);
+
             indexBuffer = std::make_shared<graphics::Buffer>();
+            indexBuffer->setResidency(graphics::Residency::KEEP);
             indexBuffer->initFromBuffer(graphics::Buffer::Usage::INDEX, indices.data(), static_cast<uint32_t>(getVectorSize(indices)), false);
 
             vertexBuffer = std::make_shared<graphics::Buffer>();
-            vertexBuffer->initFromBuffer(graphics::Buffer::Usage::VERTEX, vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)), true);
+            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, true);
 
             meshBuffer = std::make_shared<graphics::MeshBuffer>();
             meshBuffer->init(sizeof(uint16_t), indexBuffer, graphics::VertexPCT::ATTRIBUTES, vertexBuffer);
 
-            particles.resize(particleDefinition.maxParticles);
+            particleCapacity = particleDefinition.maxParticles;
+            particles.assign(particleCapacity * STREAM_COUNT, 0.0f);
+            sleepBoundingBox.reset();
+            fillEstimate = 0.0f;
+
+            updateMemoryUsage();
 
             return true;
         }
 
-        bool ParticleSystem::updateParticleMesh()
+        void ParticleSystem::buildParticleMesh()
         {
-            if (node)
+            Vector2 offset;
+
+            if (particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
             {
-                for (uint32_t counter = particleCount; counter > 0; --counter)
-                {
-                    size_t i = counter - 1;
+                offset = parentOffset;
+            }
+
+            const float* positionX = getStream(POSITION_X);
+            const float* positionY = getStream(POSITION_Y);
+            const float* colorRed = getStream(COLOR_RED);
+            const float* colorGreen = getStream(COLOR_GREEN);
+            const float* colorBlue = getStream(COLOR_BLUE);
+            const float* colorAlpha = getStream(COLOR_ALPHA);
+            const float* size = getStream(SIZE);
+            const float* rotation = getStream(ROTATION);
+
+            rotationValues.resize(particleCount * 3);
+            float* angles = rotationValues.data();
+            float* sines = angles + particleCount;
+            float* cosines = sines + particleCount;
+
+            for (uint32_t i = 0; i < particleCount; ++i)
+            {
+                angles[i] = -degToRad(rotation[i]);
+            }
 
-                    Vector2 position;
+            sinCos(angles, sines, cosines, particleCount);
 
-                    if (particleDefinition.positionType == ParticleDefinition::PositionType::FREE)
-                    {
-                        position = particles[i].position;
-                    }
-                    else if (particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
-                    {
-                        position = node->getPosition() + particles[i].position;
-                    }
+            vertices.resize(particleCount * 4);
+            updateMemoryUsage();
 
-                    float size_2 = particles[i].size / 2.0f;
-                    Vector2 v1(-size_2, -size_2);
-                    Vector2 v2(size_2, size_2);
+            graphics::VertexPCT* vertex = vertices.data();
+            fillEstimate = 0.0f;
 
-                    float r = -degToRad(particles[i].rotation);
-                    float cr = cosf(r);
-                    float sr = sinf(r);
+            for (uint32_t i = 0; i < particleCount; ++i, vertex += 4)
+            {
+                float x = positionX[i] + offset.v[0];
+                float y = positionY[i] + offset.v[1];
 
-                    Vector2 a(v1.v[0] * cr - v1.v[1] * sr, v1.v[0] * sr + v1.v[1] * cr);
-                    Vector2 b(v2.v[0] * cr - v1.v[1] * sr, v2.v[0] * sr + v1.v[1] * cr);
-                    Vector2 c(v2.v[0] * cr - v2.v[1] * sr, v2.v[0] * sr + v2.v[1] * cr);
-                    Vector2 d(v1.v[0] * cr - v2.v[1] * sr, v1.v[0] * sr + v2.v[1] * cr);
+                fillEstimate += size[i] * size[i];
 
-                    Color color(static_cast<uint8_t>(particles[i].colorRed * 255),
-                                static_cast<uint8_t>(particles[i].colorGreen * 255),
-                                static_cast<uint8_t>(particles[i].colorBlue * 255),
-                                static_cast<uint8_t>(particles[i].colorAlpha * 255));
+                float halfSize = size[i] / 2.0f;
+                float p = halfSize * cosines[i];
+                float q = halfSize * sines[i];
 
-                    vertices[i * 4 + 0].position = a + position;
-                    vertices[i * 4 + 0].color = color;
+                Color color(static_cast<uint8_t>(colorRed[i] * 255),
+                            static_cast<uint8_t>(colorGreen[i] * 255),
+                            static_cast<uint8_t>(colorBlue[i] * 255),
+                            static_cast<uint8_t>(colorAlpha[i] * 255));
 
-                    vertices[i * 4 + 1].position = b + position;
-                    vertices[i * 4 + 1].color = color;
+                vertex[0].position.set(x - p + q, y - q - p, 0.0f);
+                vertex[0].color = color;
+                vertex[0].texCoord.set(0.0f, 1.0f);
 
-                    vertices[i * 4 + 2].position = d + position;
-                    vertices[i * 4 + 2].color = color;
+                vertex[1].position.set(x + p + q, y + q - p, 0.0f);
+                vertex[1].color = color;
+                vertex[1].texCoord.set(1.0f, 1.0f);
 
-                    vertices[i * 4 + 3].position = c + position;
-                    vertices[i * 4 + 3].color = color;
-                }
+                vertex[2].position.set(x - p - q, y - q + p, 0.0f);
+                vertex[2].color = color;
+                vertex[2].texCoord.set(0.0f, 0.0f);
 
-                if (!vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices))))
-                {
-                    return false;
-                }
+                vertex[3].position.set(x + p - q, y + q + p, 0.0f);
+                vertex[3].color = color;
+                vertex[3].texCoord.set(1.0f, 0.0f);
             }
+        }
 
-            return true;
+        float ParticleSystem::getAverageParticleFill() const
+        {
+            if (particleCount)
+            {
+                return fillEstimate / static_cast<float>(particleCount);
+            }
+            else
+            {
+                float startSize = particleDefinition.startParticleSize + particleDefinition.startParticleSizeVariance;
+                return startSize * startSize;
+            }
         }
 
         void ParticleSystem::emitParticles(uint32_t count)
@@ -431,90 +787,372 @@ namespace ouzel
 
             if (count)
             {
-                if (node)
+                float* life = getStream(LIFE) + particleCount;
+                float* positionX = getStream(POSITION_X) + particleCount;
+                float* positionY = getStream(POSITION_Y) + particleCount;
+
+                if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
                 {
-                    Vector2 position;
+                    float* colorRed = getStream(COLOR_RED) + particleCount;
+                    float* colorGreen = getStream(COLOR_GREEN) + particleCount;
+                    float* colorBlue = getStream(COLOR_BLUE) + particleCount;
+                    float* colorAlpha = getStream(COLOR_ALPHA) + particleCount;
+                    float* deltaColorRed = getStream(DELTA_COLOR_RED) + particleCount;
+                    float* deltaColorGreen = getStream(DELTA_COLOR_GREEN) + particleCount;
+                    float* deltaColorBlue = getStream(DELTA_COLOR_BLUE) + particleCount;
+                    float* deltaColorAlpha = getStream(DELTA_COLOR_ALPHA) + particleCount;
+                    float* size = getStream(SIZE) + particleCount;
+                    float* deltaSize = getStream(DELTA_SIZE) + particleCount;
+                    float* rotation = getStream(ROTATION) + particleCount;
+                    float* deltaRotation = getStream(DELTA_ROTATION) + particleCount;
+                    float* radialAcceleration = getStream(RADIAL_ACCELERATION) + particleCount;
+                    float* tangentialAcceleration = getStream(TANGENTIAL_ACCELERATION) + particleCount;
+                    float* directionX = getStream(DIRECTION_X) + particleCount;
+                    float* directionY = getStream(DIRECTION_Y) + particleCount;
+
+                    // one block of random values per attribute
+                    randomValues.resize(count * 19);
+                    random.getSignedFloats(randomValues.data(), static_cast<uint32_t>(randomValues.size()));
+                    const float* r = randomValues.data();
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        life[i] = std::max(particleDefinition.particleLifespan + particleDefinition.particleLifespanVariance * r[i], 0.0f);
+                    }
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        positionX[i] = particleDefinition.sourcePosition.v[0] + emitterPosition.v[0] + particleDefinition.sourcePositionVariance.v[0] * r[i];
+                    }
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        positionY[i] = particleDefinition.sourcePosition.v[1] + emitterPosition.v[1] + particleDefinition.sourcePositionVariance.v[1] * r[i];
+                    }
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        size[i] = std::max(particleDefinition.startParticleSize + particleDefinition.startParticleSizeVariance * r[i], 0.0f);
+                    }
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        deltaSize[i] = (std::max(particleDefinition.finishParticleSize + particleDefinition.finishParticleSizeVariance * r[i], 0.0f) - size[i]) / life[i];
+                    }
+                    r += count;
+
+                    emitColors(colorRed, deltaColorRed, life, count,
+                               particleDefinition.startColorRed, particleDefinition.startColorRedVariance,
+                               particleDefinition.finishColorRed, particleDefinition.finishColorRedVariance, r);
+                    r += count * 2;
+
+                    emitColors(colorGreen, deltaColorGreen, life, count,
+                               particleDefinition.startColorGreen, particleDefinition.startColorGreenVariance,
+                               particleDefinition.finishColorGreen, particleDefinition.finishColorGreenVariance, r);
+                    r += count * 2;
+
+                    emitColors(colorBlue, deltaColorBlue, life, count,
+                               particleDefinition.startColorBlue, particleDefinition.startColorBlueVariance,
+                               particleDefinition.finishColorBlue, particleDefinition.finishColorBlueVariance, r);
+                    r += count * 2;
+
+                    emitColors(colorAlpha, deltaColorAlpha, life, count,
+                               particleDefinition.startColorAlpha, particleDefinition.startColorAlphaVariance,
+                               particleDefinition.finishColorAlpha, particleDefinition.finishColorAlphaVariance, r);
+                    r += count * 2;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        rotation[i] = particleDefinition.startRotation + particleDefinition.startRotationVariance * r[i];
+                    }
+                    r += count;
 
-                    if (particleDefinition.positionType == ParticleDefinition::PositionType::FREE)
+                    for (uint32_t i = 0; i < count; ++i)
                     {
-                        position = node->convertLocalToWorld(Vector2::ZERO);
+                        deltaRotation[i] = (particleDefinition.finishRotation + particleDefinition.finishRotationVariance * r[i] - rotation[i]) / life[i];
                     }
-                    else if (particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        radialAcceleration[i] = particleDefinition.radialAcceleration + particleDefinition.radialAcceleration * r[i];
+                    }
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
                     {
-                        position = node->convertLocalToWorld(Vector2::ZERO) - node->getPosition();
+                        tangentialAcceleration[i] = particleDefinition.tangentialAcceleration + particleDefinition.tangentialAcceleration * r[i];
                     }
+                    r += count;
+
+                    const float* angleValues = r;
+                    r += count;
+                    const float* speedValues = r;
 
-                    for (uint32_t i = particleCount; i < particleCount + count; ++i)
+                    for (uint32_t i = 0; i < count; ++i)
                     {
-                        if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
+                        float a = degToRad(particleDefinition.angle + particleDefinition.angleVariance * angleValues[i]);
+                        float s = particleDefinition.speed + particleDefinition.speedVariance * speedValues[i];
+                        directionX[i] = cosf(a) * s;
+                        directionY[i] = sinf(a) * s;
+
+                        if (particleDefinition.rotationIsDir)
                         {
-                            particles[i].life = fmaxf(particleDefinition.particleLifespan + particleDefinition.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f);
-
-                            particles[i].position = particleDefinition.sourcePosition + position + Vector2(particleDefinition.sourcePositionVariance.v[0] * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine),
-                                                                                                             particleDefinition.sourcePositionVariance.v[1] * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
-
-                            particles[i].size = fmaxf(particleDefinition.startParticleSize + particleDefinition.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f);
-
-                            float finishSize = fmaxf(particleDefinition.finishParticleSize + particleDefinition.finishParticleSizeVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f);
-                            particles[i].deltaSize = (finishSize - particles[i].size) / particles[i].life;
-
-                            particles[i].colorRed = clamp(particleDefinition.startColorRed + particleDefinition.startColorRedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            particles[i].colorGreen = clamp(particleDefinition.startColorGreen + particleDefinition.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            particles[i].colorBlue = clamp(particleDefinition.startColorBlue + particleDefinition.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            particles[i].colorAlpha = clamp(particleDefinition.startColorAlpha + particleDefinition.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-
-                            float finishColorRed = clamp(particleDefinition.finishColorRed + particleDefinition.finishColorRedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            float finishColorGreen = clamp(particleDefinition.finishColorGreen + particleDefinition.finishColorGreenVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            float finishColorBlue = clamp(particleDefinition.finishColorBlue + particleDefinition.finishColorBlueVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            float finishColorAlpha = clamp(particleDefinition.finishColorAlpha + particleDefinition.finishColorAlphaVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-
-                            particles[i].deltaColorRed = (finishColorRed - particles[i].colorRed) / particles[i].life;
-                            particles[i].deltaColorGreen = (finishColorGreen - particles[i].colorGreen) / particles[i].life;
-                            particles[i].deltaColorBlue = (finishColorBlue - particles[i].colorBlue) / particles[i].life;
-                            particles[i].deltaColorAlpha = (finishColorAlpha - particles[i].colorAlpha) / particles[i].life;
-
-                            //_particles[i].finishColor = finishColor;
-
-                            particles[i].rotation = particleDefinition.startRotation + particleDefinition.startRotationVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-
-                            float finishRotation = particleDefinition.finishRotation + particleDefinition.finishRotationVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                            particles[i].deltaRotation = (finishRotation - particles[i].rotation) / particles[i].life;
-
-                            particles[i].radialAcceleration = particleDefinition.radialAcceleration + particleDefinition.radialAcceleration * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                            particles[i].tangentialAcceleration = particleDefinition.tangentialAcceleration + particleDefinition.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-
-                            if (particleDefinition.rotationIsDir)
-                            {
-                                float a = degToRad(particleDefinition.angle + particleDefinition.angleVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
-                                Vector2 v(cosf(a), sinf(a));
-                                float s = particleDefinition.speed + particleDefinition.speedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                                Vector2 dir = v * s;
-                                particles[i].direction = dir;
-                                particles[i].rotation = -radToDeg(dir.getAngle());
-                            }
-                            else
-                            {
-                                float a = degToRad(particleDefinition.angle + particleDefinition.angleVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
-                                Vector2 v(cosf(a), sinf(a));
-                                float s = particleDefinition.speed + particleDefinition.speedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                                Vector2 dir = v * s;
-                                particles[i].direction = dir;
-                            }
+                            rotation[i] = -radToDeg(Vector2(directionX[i], directionY[i]).getAngle());
                         }
-                        else
-                        {
-                            particles[i].radius = particleDefinition.maxRadius + particleDefinition.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                            particles[i].angle = degToRad(particleDefinition.angle + particleDefinition.angleVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
-                            particles[i].degreesPerSecond = degToRad(particleDefinition.rotatePerSecond + particleDefinition.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
+                    }
+                }
+                else
+                {
+                    float* angle = getStream(ANGLE) + particleCount;
+                    float* degreesPerSecond = getStream(DEGREES_PER_SECOND) + particleCount;
+                    float* radius = getStream(RADIUS) + particleCount;
+                    float* deltaRadius = getStream(DELTA_RADIUS) + particleCount;
 
-                            float endRadius = particleDefinition.minRadius + particleDefinition.minRadiusVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                            particles[i].deltaRadius = (endRadius - particles[i].radius) / particles[i].life;
-                        }
+                    randomValues.resize(count * 4);
+                    random.getSignedFloats(randomValues.data(), static_cast<uint32_t>(randomValues.size()));
+                    const float* r = randomValues.data();
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        radius[i] = particleDefinition.maxRadius + particleDefinition.maxRadiusVariance * r[i];
+                    }
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        angle[i] = degToRad(particleDefinition.angle + particleDefinition.angleVariance * r[i]);
                     }
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        degreesPerSecond[i] = degToRad(particleDefinition.rotatePerSecond + particleDefinition.rotatePerSecondVariance * r[i]);
+                    }
+                    r += count;
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        deltaRadius[i] = (particleDefinition.minRadius + particleDefinition.minRadiusVariance * r[i] - radius[i]) / life[i];
+                    }
+                }
+
+                particleCount += count;
+            }
+        }
+
+        void ParticleSystem::updateGravityParticles(float delta, uint32_t first, uint32_t count)
+        {
+            float* life = getStream(LIFE) + first;
+            float* positionX = getStream(POSITION_X) + first;
+            float* positionY = getStream(POSITION_Y) + first;
+            float* directionX = getStream(DIRECTION_X) + first;
+            float* directionY = getStream(DIRECTION_Y) + first;
+            const float* radialAcceleration = getStream(RADIAL_ACCELERATION) + first;
+            const float* tangentialAcceleration = getStream(TANGENTIAL_ACCELERATION) + first;
+
+            float gravityX = particleDefinition.gravity.v[0];
+            float gravityY = particleDefinition.gravity.v[1];
+            float positionDelta = delta * (particleDefinition.yCoordFlipped ? 1.0f : 0.0f);
+
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                float32x4_t zero = vdupq_n_f32(0.0f);
+                float32x4_t one = vdupq_n_f32(1.0f);
+                // the length is not computed, so the squared length is compared with the squared tolerance,
+                // which is zero in float, so less or equal is used (sqrtf of the smallest denormal is above TOLERANCE)
+                float32x4_t toleranceSquared = vdupq_n_f32(TOLERANCE * TOLERANCE);
+                float32x4_t d = vdupq_n_f32(delta);
+                float32x4_t pd = vdupq_n_f32(positionDelta);
+                float32x4_t gx = vdupq_n_f32(gravityX);
+                float32x4_t gy = vdupq_n_f32(gravityY);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    vst1q_f32(life + i, vsubq_f32(vld1q_f32(life + i), d));
+
+                    float32x4_t px = vld1q_f32(positionX + i);
+                    float32x4_t py = vld1q_f32(positionY + i);
+
+                    // radial direction is the normalized position when one of the coordinates is zero
+                    uint32x4_t mask = vorrq_u32(vceqq_f32(px, zero), vceqq_f32(py, zero));
+                    float32x4_t lengthSquared = vmlaq_f32(vmulq_f32(px, px), py, py);
+                    float32x4_t inverseLength = vrsqrteq_f32(lengthSquared);
+                    inverseLength = vmulq_f32(inverseLength, vrsqrtsq_f32(vmulq_f32(lengthSquared, inverseLength), inverseLength));
+                    inverseLength = vmulq_f32(inverseLength, vrsqrtsq_f32(vmulq_f32(lengthSquared, inverseLength), inverseLength));
+                    float32x4_t scale = vbslq_f32(vcleq_f32(lengthSquared, toleranceSquared), one, inverseLength);
+                    scale = vbslq_f32(mask, scale, zero);
+
+                    float32x4_t rx = vmulq_f32(px, scale);
+                    float32x4_t ry = vmulq_f32(py, scale);
+                    float32x4_t ra = vld1q_f32(radialAcceleration + i);
+                    float32x4_t ta = vld1q_f32(tangentialAcceleration + i);
+
+                    float32x4_t ax = vaddq_f32(vmlsq_f32(vmulq_f32(rx, ra), ry, ta), gx);
+                    float32x4_t ay = vaddq_f32(vmlaq_f32(vmulq_f32(ry, ra), rx, ta), gy);
+
+                    float32x4_t dx = vmlaq_f32(vld1q_f32(directionX + i), ax, d);
+                    float32x4_t dy = vmlaq_f32(vld1q_f32(directionY + i), ay, d);
+                    vst1q_f32(directionX + i, dx);
+                    vst1q_f32(directionY + i, dy);
+
+                    vst1q_f32(positionX + i, vmlaq_f32(px, dx, pd));
+                    vst1q_f32(positionY + i, vmlaq_f32(py, dy, pd));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 zero = _mm_setzero_ps();
+            __m128 one = _mm_set1_ps(1.0f);
+            __m128 tolerance = _mm_set1_ps(TOLERANCE);
+            __m128 d = _mm_set1_ps(delta);
+            __m128 pd = _mm_set1_ps(positionDelta);
+            __m128 gx = _mm_set1_ps(gravityX);
+            __m128 gy = _mm_set1_ps(gravityY);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), d));
+
+                __m128 px = _mm_loadu_ps(positionX + i);
+                __m128 py = _mm_loadu_ps(positionY + i);
+
+                // radial direction is the normalized position when one of the coordinates is zero
+                __m128 mask = _mm_or_ps(_mm_cmpeq_ps(px, zero), _mm_cmpeq_ps(py, zero));
+                __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)));
+                __m128 nearZero = _mm_cmplt_ps(length, tolerance);
+                __m128 scale = _mm_or_ps(_mm_and_ps(nearZero, one), _mm_andnot_ps(nearZero, _mm_div_ps(one, length)));
+                scale = _mm_and_ps(mask, scale);
+
+                __m128 rx = _mm_mul_ps(px, scale);
+                __m128 ry = _mm_mul_ps(py, scale);
+                __m128 ra = _mm_loadu_ps(radialAcceleration + i);
+                __m128 ta = _mm_loadu_ps(tangentialAcceleration + i);
+
+                __m128 ax = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, ra), _mm_mul_ps(ry, ta)), gx);
+                __m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, ra), _mm_mul_ps(rx, ta)), gy);
+
+                __m128 dx = _mm_add_ps(_mm_loadu_ps(directionX + i), _mm_mul_ps(ax, d));
+                __m128 dy = _mm_add_ps(_mm_loadu_ps(directionY + i), _mm_mul_ps(ay, d));
+                _mm_storeu_ps(directionX + i, dx);
+                _mm_storeu_ps(directionY + i, dy);
+
+                _mm_storeu_ps(positionX + i, _mm_add_ps(px, _mm_mul_ps(dx, pd)));
+                _mm_storeu_ps(positionY + i, _mm_add_ps(py, _mm_mul_ps(dy, pd)));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                life[i] -= delta;
+
+                float rx = 0.0f;
+                float ry = 0.0f;
 
-                    particleCount += count;
+                // radial direction is the normalized position when one of the coordinates is zero
+                if (positionX[i] == 0.0f || positionY[i] == 0.0f)
+                {
+                    float length = sqrtf(positionX[i] * positionX[i] + positionY[i] * positionY[i]);
+                    float scale = (length < TOLERANCE) ? 1.0f : 1.0f / length;
+                    rx = positionX[i] * scale;
+                    ry = positionY[i] * scale;
                 }
+
+                float ax = rx * radialAcceleration[i] - ry * tangentialAcceleration[i] + gravityX;
+                float ay = ry * radialAcceleration[i] + rx * tangentialAcceleration[i] + gravityY;
+
+                directionX[i] += ax * delta;
+                directionY[i] += ay * delta;
+
+                positionX[i] += directionX[i] * positionDelta;
+                positionY[i] += directionY[i] * positionDelta;
             }
         }
+
+        void ParticleSystem::updateRadiusParticles(float delta, uint32_t first, uint32_t count)
+        {
+            float* life = getStream(LIFE) + first;
+            float* positionX = getStream(POSITION_X) + first;
+            float* positionY = getStream(POSITION_Y) + first;
+            float* angle = getStream(ANGLE) + first;
+            float* radius = getStream(RADIUS) + first;
+            const float* degreesPerSecond = getStream(DEGREES_PER_SECOND) + first;
+            const float* deltaRadius = getStream(DELTA_RADIUS) + first;
+
+            float flip = particleDefinition.yCoordFlipped ? 1.0f : 0.0f;
+
+            addScaled(life, nullptr, -delta, count);
+            addScaled(angle, degreesPerSecond, delta, count);
+            addScaled(radius, deltaRadius, delta, count);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                positionX[i] = -cosf(angle[i]) * radius[i];
+                positionY[i] = -sinf(angle[i]) * radius[i] * flip;
+            }
+        }
+
+        void ParticleSystem::updateParticleColors(float delta, uint32_t first, uint32_t count)
+        {
+            addScaled(getStream(COLOR_RED) + first, getStream(DELTA_COLOR_RED) + first, delta, count);
+            addScaled(getStream(COLOR_GREEN) + first, getStream(DELTA_COLOR_GREEN) + first, delta, count);
+            addScaled(getStream(COLOR_BLUE) + first, getStream(DELTA_COLOR_BLUE) + first, delta, count);
+            addScaled(getStream(COLOR_ALPHA) + first, getStream(DELTA_COLOR_ALPHA) + first, delta, count);
+            addScaled(getStream(SIZE) + first, getStream(DELTA_SIZE) + first, delta, count, true);
+            addScaled(getStream(ROTATION) + first, getStream(DELTA_ROTATION) + first, delta, count);
+        }
+
+        void ParticleSystem::removeDeadParticles()
+        {
+            const float* life = getStream(LIFE);
+
+            // iterates from the back, so that the particle swapped into a dead slot has already been checked
+            for (uint32_t i = particleCount; i > 0;)
+            {
+                if (i >= 4 && !hasDeadParticles(life + i - 4))
+                {
+                    i -= 4;
+                    continue;
+                }
+
+                --i;
+
+                if (life[i] < 0.0f)
+                {
+                    moveParticle(particleCount - 1, i);
+                    --particleCount;
+                }
+            }
+        }
+
+        void ParticleSystem::moveParticle(uint32_t from, uint32_t to)
+        {
+            if (from != to)
+            {
+                float* data = particles.data();
+
+                for (uint32_t stream = 0; stream < STREAM_COUNT; ++stream, data += particleCapacity)
+                {
+                    data[to] = data[from];
+                }
+            }
+        }
+
+        void ParticleSystem::updateMemoryUsage()
+        {
+            size_t newMemorySize = (particles.capacity() + rotationValues.capacity() + randomValues.capacity()) * sizeof(float) +
+                indices.capacity() * sizeof(uint16_t) +
+                vertices.capacity() * sizeof(graphics::VertexPCT);
+
+            MemoryTracker::update(MemoryTracker::Tag::SCENE, memorySize, newMemorySize);
+        }
     } // namespace scene
 } // namespace ouzel
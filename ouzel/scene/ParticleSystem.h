@@ -6,13 +6,16 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include "core/CompileConfig.h"
+#include "core/JobSystem.h"
 #include "scene/Component.h"
 #include "utils/Types.h"
+#include "utils/Random.h"
 #include "scene/ParticleDefinition.h"
 #include "math/Vector2.h"
 #include "math/Color.h"
 #include "graphics/Vertex.h"
-#include "core/UpdateCallback.h"
+#include "math/Matrix4.h"
 #include "graphics/BlendState.h"
 #include "graphics/Buffer.h"
 #include "graphics/MeshBuffer.h"
@@ -23,11 +26,15 @@ namespace ouzel
 {
     namespace scene
     {
+        class ParticleManager;
+
         class ParticleSystem: public Component
         {
+            friend ParticleManager;
         public:
             ParticleSystem();
             ParticleSystem(const std::string& filename);
+            virtual ~ParticleSystem();
 
             virtual void draw(const Matrix4& transformMatrix,
                               const Color& drawColor,
@@ -49,16 +56,48 @@ namespace ouzel
             bool isRunning() const { return running; }
             bool isActive() const { return active; }
 
-            void setPositionType(ParticleDefinition::PositionType newPositionType) { particleDefinition.positionType = newPositionType; }
+            void setPositionType(ParticleDefinition::PositionType newPositionType) { finishPreWarm(); particleDefinition.positionType = newPositionType; }
             ParticleDefinition::PositionType getPositionType() const { return particleDefinition.positionType; }
 
+            // simulates the given time in fixed steps before the system is first shown, optionally on a worker thread
+            void preWarm(float duration, float step = 0.1f, bool async = false);
+            bool isPreWarming() const { return preWarmTime > 0.0f || preWarmPending; }
+
+            // advances the simulation in fixed steps, only the last particle lifespan is actually simulated
+            void fastForward(float duration, float step = 0.1f);
+
+            // a running system that has not been drawn for sleepDelay seconds stops simulating,
+            // and is fast-forwarded when it gets visible again
+            void setSleepWhenHidden(bool newSleepWhenHidden, float newSleepDelay = 0.5f) { sleepWhenHidden = newSleepWhenHidden; sleepDelay = newSleepDelay; }
+            bool isSleepWhenHidden() const { return sleepWhenHidden; }
+            bool isSleeping() const { return sleeping; }
+
+            void setFastForwardStep(float newFastForwardStep) { fastForwardStep = newFastForwardStep; }
+            float getFastForwardStep() const { return fastForwardStep; }
+
+            // the same seed produces the same particles, reset() restarts the sequence
+            void setRandomSeed(uint64_t seed) { finishPreWarm(); random.setSeed(seed); }
+            uint64_t getRandomSeed() const { return random.getSeed(); }
+
+            // systems with higher priority get emission first when the particle manager is over budget
+            void setPriority(float newPriority) { priority = newPriority; }
+            float getPriority() const { return priority; }
+
+            // sum of squared particle sizes of the last built mesh
+            float getFillEstimate() const { return fillEstimate; }
+            float getAverageParticleFill() const;
+
             void setFinishHandler(const std::function<void()>& handler) { finishHandler = handler; }
 
         protected:
             bool createParticleMesh();
-            bool updateParticleMesh();
+            void buildParticleMesh();
 
             void emitParticles(uint32_t count);
+            void fastForwardSimulation(float duration, float step);
+
+            // waits for the asynchronous prewarm, the worker owns the simulation state until then
+            void finishPreWarm();
 
             ParticleDefinition particleDefinition;
 
@@ -67,41 +106,56 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> texture;
             std::shared_ptr<graphics::Texture> whitePixelTexture;
 
-            struct Particle
+            // particles are stored as structure of arrays, one stream of maxParticles floats per attribute
+            enum Stream
             {
-                float life = 0.0f;
-
-                Vector2 position;
-
-                float colorRed = 0.0f;
-                float colorGreen = 0.0f;
-                float colorBlue = 0.0f;
-                float colorAlpha = 0.0f;
-
-                float deltaColorRed = 0.0f;
-                float deltaColorGreen = 0.0f;
-                float deltaColorBlue = 0.0f;
-                float deltaColorAlpha = 0.0f;
-
-                float angle = 0.0f;
-                float speed = 0.0f;
-
-                float size = 0.0f;
-                float deltaSize = 0.0f;
+                LIFE,
+                POSITION_X,
+                POSITION_Y,
+                COLOR_RED,
+                COLOR_GREEN,
+                COLOR_BLUE,
+                COLOR_ALPHA,
+                DELTA_COLOR_RED,
+                DELTA_COLOR_GREEN,
+                DELTA_COLOR_BLUE,
+                DELTA_COLOR_ALPHA,
+                SIZE,
+                DELTA_SIZE,
+                ROTATION,
+                DELTA_ROTATION,
+                RADIAL_ACCELERATION,
+                TANGENTIAL_ACCELERATION,
+                DIRECTION_X,
+                DIRECTION_Y,
+                ANGLE,
+                DEGREES_PER_SECOND,
+                RADIUS,
+                DELTA_RADIUS,
+                STREAM_COUNT
+            };
 
-                float rotation = 0.0f;
-                float deltaRotation = 0.0f;
+            float* getStream(Stream stream) { return particles.data() + stream * particleCapacity; }
+            const float* getStream(Stream stream) const { return particles.data() + stream * particleCapacity; }
 
-                float radialAcceleration = 0.0f;
-                float tangentialAcceleration = 0.0f;
+            // update stages run by the ParticleManager, only beginUpdate and endUpdate may access the node
+            bool beginUpdate(float delta);
+            void updateNodeState();
+            uint32_t updateEmission(float delta);
+            void emitPendingParticles();
+            void simulateParticles(float delta, uint32_t first, uint32_t count);
+            void finishSimulation();
+            void endUpdate();
 
-                Vector2 direction;
-                float radius = 0.0f;
-                float degreesPerSecond = 0.0f;
-                float deltaRadius = 0.0f;
-            };
+            void updateGravityParticles(float delta, uint32_t first, uint32_t count);
+            void updateRadiusParticles(float delta, uint32_t first, uint32_t count);
+            void updateParticleColors(float delta, uint32_t first, uint32_t count);
+            void removeDeadParticles();
+            void moveParticle(uint32_t from, uint32_t to);
+            void updateMemoryUsage();
 
-            std::vector<Particle> particles;
+            std::vector<float> particles;
+            uint32_t particleCapacity = 0;
 
             std::shared_ptr<graphics::MeshBuffer> meshBuffer;
             std::shared_ptr<graphics::Buffer> indexBuffer;
@@ -109,18 +163,48 @@ namespace ouzel
 
             std::vector<uint16_t> indices;
             std::vector<graphics::VertexPCT> vertices;
+            std::vector<float> rotationValues;
 
             uint32_t particleCount = 0;
 
+            Random random;
+            std::vector<float> randomValues;
+
             float emitCounter = 0.0f;
             float elapsed = 0.0f;
             bool active = false;
             bool running = false;
             bool finished = false;
 
-            bool needsMeshUpdate = false;
-
-            UpdateCallback updateCallback;
+            uint32_t pendingEmitCount = 0;
+            Vector2 emitterPosition;
+            Vector2 worldPosition;
+            Vector2 parentOffset;
+            Matrix4 inverseTransform;
+            Vector2 minPosition;
+            Vector2 maxPosition;
+
+            bool needsMeshUpload = false;
+
+            float priority = 1.0f;
+            float fillEstimate = 0.0f;
+
+            float preWarmTime = 0.0f;
+            float preWarmStep = 0.1f;
+            bool preWarmAsync = false;
+            bool preWarmPending = false;
+            JobSystem::Counter preWarmCounter;
+
+            bool sleepWhenHidden = false;
+            float sleepDelay = 0.5f;
+            float fastForwardStep = 0.1f;
+            float timeSinceDraw = 0.0f;
+            float sleepTime = 0.0f;
+            bool sleeping = false;
+            bool wakeRequested = false;
+            AABB3 sleepBoundingBox;
+
+            size_t memorySize = 0;
 
             std::function<void()> finishHandler;
         };
@@ -10,6 +10,7 @@
 #include "core/Cache.h"
 #include "Layer.h"
 #include "Camera.h"
+#include "StaticBatch.h"
 #include "math/MathUtils.h"
 #include "utils/Utils.h"
 
@@ -50,11 +51,13 @@ namespace ouzel
 
             for (const DrawCommand& drawCommand : drawCommands)
             {
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+                FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
 
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+                FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
+
+                FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
 
                 sharedEngine->getRenderer()->addDrawCommand(std::vector<std::shared_ptr<graphics::Texture>>(),
                                                             shader,
@@ -90,11 +93,13 @@ namespace ouzel
 
             for (const DrawCommand& drawCommand : drawCommands)
             {
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+                FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+                FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
 
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+                FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
 
                 sharedEngine->getRenderer()->addDrawCommand(std::vector<std::shared_ptr<graphics::Texture>>(),
                                                             shader,
@@ -113,6 +118,30 @@ namespace ouzel
             }
         }
 
+        bool ShapeDrawable::bake(const Matrix4& transformMatrix,
+                                 const Color& drawColor,
+                                 StaticBatch& staticBatch) const
+        {
+            if (shader != sharedEngine->getCache()->getShader(graphics::SHADER_COLOR))
+            {
+                return false;
+            }
+
+            for (const DrawCommand& drawCommand : drawCommands)
+            {
+                staticBatch.addGeometry(blendState,
+                                        drawCommand.mode,
+                                        indices,
+                                        drawCommand.startIndex,
+                                        drawCommand.indexCount,
+                                        vertices,
+                                        transformMatrix,
+                                        drawColor);
+            }
+
+            return true;
+        }
+
         void ShapeDrawable::clear()
         {
             boundingBox = AABB3();
@@ -122,6 +151,8 @@ namespace ouzel
             vertices.clear();
 
             dirty = true;
+
+            invalidateNode();
         }
 
         void ShapeDrawable::point(const Vector2& position, const Color& color)
@@ -142,6 +173,8 @@ namespace ouzel
             boundingBox.insertPoint(position);
 
             dirty = true;
+
+            invalidateNode();
         }
 
         void ShapeDrawable::line(const Vector2& start, const Vector2& finish, const Color& color)
@@ -166,6 +199,8 @@ namespace ouzel
             boundingBox.insertPoint(finish);
 
             dirty = true;
+
+            invalidateNode();
         }
 
         void ShapeDrawable::circle(const Vector2& position, float radius, const Color& color, bool fill, uint32_t segments)
@@ -229,6 +264,8 @@ namespace ouzel
             boundingBox.insertPoint(Vector2(position.v[0] + radius, position.v[1] + radius));
 
             dirty = true;
+
+            invalidateNode();
         }
 
         void ShapeDrawable::rectangle(const Rectangle& rectangle, const Color& color, bool fill)
@@ -272,6 +309,8 @@ namespace ouzel
             boundingBox.insertPoint(rectangle.topRight());
 
             dirty = true;
+
+            invalidateNode();
         }
 
         void ShapeDrawable::triangle(const Vector2 (&positions)[3], const Color& color, bool fill)
@@ -303,6 +342,8 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+
+            invalidateNode();
         }
 
         void ShapeDrawable::polygon(const std::vector<Vector2>& edges, const Color& color, bool fill)
@@ -348,6 +389,8 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+
+            invalidateNode();
         }
 
     } // namespace scene
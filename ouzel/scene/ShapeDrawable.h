@@ -29,6 +29,10 @@ namespace ouzel
                                        const Color& drawColor,
                                        scene::Camera* camera) override;
 
+            virtual bool bake(const Matrix4& transformMatrix,
+                              const Color& drawColor,
+                              StaticBatch& staticBatch) const override;
+
             void clear();
 
             void point(const Vector2& position, const Color& color);
@@ -39,10 +43,10 @@ namespace ouzel
             void polygon(const std::vector<Vector2>& edges, const Color& color, bool fill = false);
 
             virtual const std::shared_ptr<graphics::Shader>& getShader() const { return shader; }
-            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; }
+            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; invalidateNode(); }
 
             virtual const std::shared_ptr<graphics::BlendState>& getBlendState() const { return blendState; }
-            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; }
+            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; invalidateNode(); }
 
         protected:
             struct DrawCommand
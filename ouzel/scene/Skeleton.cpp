@@ -0,0 +1,322 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#endif
+#include "Skeleton.h"
+#include "utils/Log.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static void getPoseMatrix(const Skeleton::BonePose& pose, float* matrix)
+        {
+            float sine = sinf(pose.rotation);
+            float cosine = cosf(pose.rotation);
+
+            matrix[0] = cosine * pose.scale.v[0];
+            matrix[1] = sine * pose.scale.v[0];
+            matrix[2] = -sine * pose.scale.v[1];
+            matrix[3] = cosine * pose.scale.v[1];
+            matrix[4] = pose.position.v[0];
+            matrix[5] = pose.position.v[1];
+            matrix[6] = 0.0f;
+            matrix[7] = 0.0f;
+        }
+
+        static void multiplyMatrices(const float* a, const float* b, float* result)
+        {
+            float r0 = a[0] * b[0] + a[2] * b[1];
+            float r1 = a[1] * b[0] + a[3] * b[1];
+            float r2 = a[0] * b[2] + a[2] * b[3];
+            float r3 = a[1] * b[2] + a[3] * b[3];
+            float r4 = a[0] * b[4] + a[2] * b[5] + a[4];
+            float r5 = a[1] * b[4] + a[3] * b[5] + a[5];
+
+            result[0] = r0;
+            result[1] = r1;
+            result[2] = r2;
+            result[3] = r3;
+            result[4] = r4;
+            result[5] = r5;
+            result[6] = 0.0f;
+            result[7] = 0.0f;
+        }
+
+        static void invertMatrix(const float* matrix, float* result)
+        {
+            float det = matrix[0] * matrix[3] - matrix[1] * matrix[2];
+            float invDet = (det != 0.0f) ? 1.0f / det : 0.0f;
+
+            float a = matrix[3] * invDet;
+            float b = -matrix[1] * invDet;
+            float c = -matrix[2] * invDet;
+            float d = matrix[0] * invDet;
+
+            result[4] = -(a * matrix[4] + c * matrix[5]);
+            result[5] = -(b * matrix[4] + d * matrix[5]);
+            result[0] = a;
+            result[1] = b;
+            result[2] = c;
+            result[3] = d;
+            result[6] = 0.0f;
+            result[7] = 0.0f;
+        }
+
+        Skeleton::Skeleton()
+        {
+        }
+
+        int32_t Skeleton::addBone(const std::string& name, int32_t parent, const BonePose& bindPose)
+        {
+            if (parent >= static_cast<int32_t>(bones.size()) || bones.size() >= std::numeric_limits<uint16_t>::max())
+            {
+                Log(Log::Level::ERR) << "Invalid parent for bone " << name;
+                return -1;
+            }
+
+            Bone bone;
+            bone.name = name;
+            bone.parent = parent;
+            bone.bindPose = bindPose;
+            bones.push_back(bone);
+
+            // world bind matrix, the parent's one is recovered from its inverse
+            float matrix[MATRIX_SIZE];
+            getPoseMatrix(bindPose, matrix);
+
+            if (parent >= 0)
+            {
+                float parentMatrix[MATRIX_SIZE];
+                invertMatrix(&inverseBindMatrices[static_cast<size_t>(parent) * MATRIX_SIZE], parentMatrix);
+                multiplyMatrices(parentMatrix, matrix, matrix);
+            }
+
+            inverseBindMatrices.resize(bones.size() * MATRIX_SIZE);
+            invertMatrix(matrix, &inverseBindMatrices[(bones.size() - 1) * MATRIX_SIZE]);
+
+            ++version;
+
+            return static_cast<int32_t>(bones.size() - 1);
+        }
+
+        int32_t Skeleton::findBone(const std::string& name) const
+        {
+            for (uint32_t i = 0; i < bones.size(); ++i)
+            {
+                if (bones[i].name == name) return static_cast<int32_t>(i);
+            }
+
+            return -1;
+        }
+
+        bool Skeleton::setSkin(const SpriteFrame& spriteFrame, const std::vector<VertexWeights>& newWeights)
+        {
+            if (newWeights.size() != spriteFrame.getVertices().size())
+            {
+                Log(Log::Level::ERR) << "Skin must have weights for every vertex";
+                return false;
+            }
+
+            for (const VertexWeights& vertexWeights : newWeights)
+            {
+                for (uint32_t i = 0; i < MAX_INFLUENCES; ++i)
+                {
+                    if (vertexWeights.weights[i] != 0.0f && vertexWeights.bones[i] >= bones.size())
+                    {
+                        Log(Log::Level::ERR) << "Skin references an invalid bone";
+                        return false;
+                    }
+                }
+            }
+
+            texture = spriteFrame.getTexture();
+            indices = spriteFrame.getIndices();
+            vertices = spriteFrame.getVertices();
+            weights = newWeights;
+
+            // unused influences point to the first bone, so skinning does not have to check them
+            for (VertexWeights& vertexWeights : weights)
+            {
+                for (uint32_t i = 0; i < MAX_INFLUENCES; ++i)
+                {
+                    if (vertexWeights.weights[i] == 0.0f) vertexWeights.bones[i] = 0;
+                }
+            }
+
+            ++version;
+
+            return true;
+        }
+
+        void Skeleton::computeSkinMatrices(const std::vector<BonePose>& pose, std::vector<float>& skinMatrices) const
+        {
+            skinMatrices.resize(bones.size() * MATRIX_SIZE);
+
+            // world matrices are built in place, parents are always before their children
+            for (uint32_t i = 0; i < bones.size(); ++i)
+            {
+                float* matrix = &skinMatrices[i * MATRIX_SIZE];
+                getPoseMatrix((i < pose.size()) ? pose[i] : bones[i].bindPose, matrix);
+
+                if (bones[i].parent >= 0)
+                {
+                    multiplyMatrices(&skinMatrices[static_cast<size_t>(bones[i].parent) * MATRIX_SIZE], matrix, matrix);
+                }
+            }
+
+            for (uint32_t i = 0; i < bones.size(); ++i)
+            {
+                float* matrix = &skinMatrices[i * MATRIX_SIZE];
+                multiplyMatrices(matrix, &inverseBindMatrices[i * MATRIX_SIZE], matrix);
+            }
+        }
+
+        void Skeleton::skin(const float* skinMatrices, graphics::VertexPCT* output, AABB2& boundingBox) const
+        {
+            uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+            uint32_t i = 0;
+
+            Vector2 minPosition(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+            Vector2 maxPosition(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+
+            // without bones there are no skin matrices, so the mesh stays in the bind pose
+            if (bones.empty())
+            {
+                for (; i < vertexCount; ++i)
+                {
+                    const Vector3& position = vertices[i].position;
+                    output[i].position = position;
+
+                    minPosition.v[0] = std::min(minPosition.v[0], position.v[0]);
+                    minPosition.v[1] = std::min(minPosition.v[1], position.v[1]);
+                    maxPosition.v[0] = std::max(maxPosition.v[0], position.v[0]);
+                    maxPosition.v[1] = std::max(maxPosition.v[1], position.v[1]);
+                }
+
+                boundingBox.min = minPosition;
+                boundingBox.max = maxPosition;
+                return;
+            }
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                float32x2_t minVector = vld1_f32(minPosition.v);
+                float32x2_t maxVector = vld1_f32(maxPosition.v);
+
+                for (; i < vertexCount; ++i)
+                {
+                    const VertexWeights& vertexWeights = weights[i];
+
+                    // blend the matrices of the influencing bones, then transform once
+                    const float* matrix = skinMatrices + vertexWeights.bones[0] * MATRIX_SIZE;
+                    float32x4_t rotation = vmulq_n_f32(vld1q_f32(matrix), vertexWeights.weights[0]);
+                    float32x2_t translation = vmul_n_f32(vld1_f32(matrix + 4), vertexWeights.weights[0]);
+
+                    for (uint32_t j = 1; j < MAX_INFLUENCES; ++j)
+                    {
+                        matrix = skinMatrices + vertexWeights.bones[j] * MATRIX_SIZE;
+                        rotation = vmlaq_n_f32(rotation, vld1q_f32(matrix), vertexWeights.weights[j]);
+                        translation = vmla_n_f32(translation, vld1_f32(matrix + 4), vertexWeights.weights[j]);
+                    }
+
+                    const Vector3& position = vertices[i].position;
+                    float32x4_t xxyy = vcombine_f32(vdup_n_f32(position.v[0]), vdup_n_f32(position.v[1]));
+                    float32x4_t products = vmulq_f32(rotation, xxyy);
+                    float32x2_t result = vadd_f32(vadd_f32(vget_low_f32(products), vget_high_f32(products)), translation);
+
+                    vst1_f32(output[i].position.v, result);
+                    output[i].position.v[2] = position.v[2];
+
+                    minVector = vmin_f32(minVector, result);
+                    maxVector = vmax_f32(maxVector, result);
+                }
+
+                vst1_f32(minPosition.v, minVector);
+                vst1_f32(maxPosition.v, maxVector);
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 minVector = _mm_setr_ps(minPosition.v[0], minPosition.v[1], 0.0f, 0.0f);
+            __m128 maxVector = _mm_setr_ps(maxPosition.v[0], maxPosition.v[1], 0.0f, 0.0f);
+
+            for (; i < vertexCount; ++i)
+            {
+                const VertexWeights& vertexWeights = weights[i];
+
+                // blend the matrices of the influencing bones, then transform once
+                const float* matrix = skinMatrices + vertexWeights.bones[0] * MATRIX_SIZE;
+                __m128 weight = _mm_set1_ps(vertexWeights.weights[0]);
+                __m128 rotation = _mm_mul_ps(_mm_loadu_ps(matrix), weight);
+                __m128 translation = _mm_mul_ps(_mm_loadu_ps(matrix + 4), weight);
+
+                for (uint32_t j = 1; j < MAX_INFLUENCES; ++j)
+                {
+                    matrix = skinMatrices + vertexWeights.bones[j] * MATRIX_SIZE;
+                    weight = _mm_set1_ps(vertexWeights.weights[j]);
+                    rotation = _mm_add_ps(rotation, _mm_mul_ps(_mm_loadu_ps(matrix), weight));
+                    translation = _mm_add_ps(translation, _mm_mul_ps(_mm_loadu_ps(matrix + 4), weight));
+                }
+
+                const Vector3& position = vertices[i].position;
+                __m128 products = _mm_mul_ps(rotation, _mm_setr_ps(position.v[0], position.v[0], position.v[1], position.v[1]));
+                __m128 result = _mm_add_ps(_mm_add_ps(products, _mm_movehl_ps(products, products)), translation);
+
+                _mm_storel_pi(reinterpret_cast<__m64*>(output[i].position.v), result);
+                output[i].position.v[2] = position.v[2];
+
+                minVector = _mm_min_ps(minVector, result);
+                maxVector = _mm_max_ps(maxVector, result);
+            }
+
+            _mm_storel_pi(reinterpret_cast<__m64*>(minPosition.v), minVector);
+            _mm_storel_pi(reinterpret_cast<__m64*>(maxPosition.v), maxVector);
+#endif
+
+            for (; i < vertexCount; ++i)
+            {
+                const VertexWeights& vertexWeights = weights[i];
+
+                float blended[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+                for (uint32_t j = 0; j < MAX_INFLUENCES; ++j)
+                {
+                    const float* matrix = skinMatrices + vertexWeights.bones[j] * MATRIX_SIZE;
+                    float weight = vertexWeights.weights[j];
+
+                    for (uint32_t k = 0; k < 6; ++k)
+                    {
+                        blended[k] += matrix[k] * weight;
+                    }
+                }
+
+                const Vector3& position = vertices[i].position;
+                float x = blended[0] * position.v[0] + blended[2] * position.v[1] + blended[4];
+                float y = blended[1] * position.v[0] + blended[3] * position.v[1] + blended[5];
+
+                output[i].position.v[0] = x;
+                output[i].position.v[1] = y;
+                output[i].position.v[2] = position.v[2];
+
+                minPosition.v[0] = std::min(minPosition.v[0], x);
+                minPosition.v[1] = std::min(minPosition.v[1], y);
+                maxPosition.v[0] = std::max(maxPosition.v[0], x);
+                maxPosition.v[1] = std::max(maxPosition.v[1], y);
+            }
+
+            boundingBox.min = minPosition;
+            boundingBox.max = maxPosition;
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,88 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "utils/Noncopyable.h"
+#include "math/AABB2.h"
+#include "math/Vector2.h"
+#include "scene/SpriteFrame.h"
+#include "graphics/Vertex.h"
+#include "graphics/Texture.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Bone hierarchy with a skinned mesh, shared read-only by all SkinnedMesh instances.
+        // Skinning does not depend on the renderer, so it can also be run headless.
+        class Skeleton: public Noncopyable
+        {
+        public:
+            static const uint32_t MAX_INFLUENCES = 4;
+            // every skin matrix is stored as 8 floats: a, b, c, d, tx, ty and padding
+            // (x' = a * x + c * y + tx, y' = b * x + d * y + ty)
+            static const uint32_t MATRIX_SIZE = 8;
+
+            struct BonePose
+            {
+                Vector2 position;
+                float rotation = 0.0f;
+                Vector2 scale = Vector2(1.0f, 1.0f);
+            };
+
+            struct Bone
+            {
+                std::string name;
+                int32_t parent; // -1 for root bones, parents are always stored before their children
+                BonePose bindPose;
+            };
+
+            struct VertexWeights
+            {
+                uint16_t bones[MAX_INFLUENCES];
+                float weights[MAX_INFLUENCES];
+            };
+
+            Skeleton();
+
+            // the bind pose is relative to the parent bone, returns the index of the new bone or -1
+            int32_t addBone(const std::string& name, int32_t parent, const BonePose& bindPose);
+            int32_t findBone(const std::string& name) const;
+            const std::vector<Bone>& getBones() const { return bones; }
+            uint32_t getBoneCount() const { return static_cast<uint32_t>(bones.size()); }
+
+            // the mesh of the sprite frame in the bind pose, with one set of weights per vertex
+            bool setSkin(const SpriteFrame& spriteFrame, const std::vector<VertexWeights>& newWeights);
+
+            const std::shared_ptr<graphics::Texture>& getTexture() const { return texture; }
+            const std::vector<uint16_t>& getIndices() const { return indices; }
+            const std::vector<graphics::VertexPCT>& getVertices() const { return vertices; }
+            const std::vector<VertexWeights>& getWeights() const { return weights; }
+
+            // changes every time a bone is added or the skin is set
+            uint32_t getVersion() const { return version; }
+
+            // local bone poses to skin matrices (boneCount * MATRIX_SIZE floats)
+            void computeSkinMatrices(const std::vector<BonePose>& pose, std::vector<float>& skinMatrices) const;
+
+            // writes skinned positions to the output vertices, which must have the texture coordinates and colors of getVertices()
+            void skin(const float* skinMatrices, graphics::VertexPCT* output, AABB2& boundingBox) const;
+
+        protected:
+            std::vector<Bone> bones;
+            std::vector<float> inverseBindMatrices;
+
+            std::shared_ptr<graphics::Texture> texture;
+            std::vector<uint16_t> indices;
+            std::vector<graphics::VertexPCT> vertices;
+            std::vector<VertexWeights> weights;
+
+            uint32_t version = 0;
+        };
+    } // namespace scene
+} // namespace ouzel
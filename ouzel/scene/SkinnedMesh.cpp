@@ -0,0 +1,366 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <cmath>
+#include "SkinnedMesh.h"
+#include "core/Engine.h"
+#include "core/Cache.h"
+#include "graphics/Renderer.h"
+#include "Camera.h"
+#include "utils/MemoryTracker.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // position x, position y, rotation, scale x, scale y
+        static const uint32_t CHANNEL_COUNT = 5;
+
+        static int32_t getChannel(AnimationClip::Property property)
+        {
+            switch (property)
+            {
+                case AnimationClip::Property::POSITION_X: return 0;
+                case AnimationClip::Property::POSITION_Y: return 1;
+                case AnimationClip::Property::ROTATION_Z: return 2;
+                case AnimationClip::Property::SCALE_X: return 3;
+                case AnimationClip::Property::SCALE_Y: return 4;
+                default: return -1;
+            }
+        }
+
+        SkinnedMesh::SkinnedMesh()
+        {
+            shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
+            whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
+
+            updateCallback.callback = std::bind(&SkinnedMesh::update, this, std::placeholders::_1);
+            sharedEngine->scheduleUpdate(&updateCallback);
+        }
+
+        SkinnedMesh::SkinnedMesh(const std::shared_ptr<Skeleton>& newSkeleton):
+            SkinnedMesh()
+        {
+            init(newSkeleton);
+        }
+
+        SkinnedMesh::~SkinnedMesh()
+        {
+            sharedEngine->unscheduleUpdate(&updateCallback);
+
+            MemoryTracker::update(MemoryTracker::Tag::SCENE, memorySize, 0);
+        }
+
+        bool SkinnedMesh::init(const std::shared_ptr<Skeleton>& newSkeleton)
+        {
+            skeleton = newSkeleton;
+            clips.clear();
+            pose.clear();
+            vertices.clear();
+            boundingBox.reset();
+
+            if (!skeleton)
+            {
+                meshBuffer.reset();
+                return false;
+            }
+
+            createMesh();
+
+            return true;
+        }
+
+        void SkinnedMesh::createMesh()
+        {
+            pose.clear();
+
+            for (const Skeleton::Bone& bone : skeleton->getBones())
+            {
+                pose.push_back(bone.bindPose);
+            }
+
+            // only positions change when skinning, so colors and texture coordinates are copied once
+            vertices = skeleton->getVertices();
+            skeletonVersion = skeleton->getVersion();
+            indexCount = static_cast<uint32_t>(skeleton->getIndices().size());
+
+            indexBuffer = std::make_shared<graphics::Buffer>();
+            indexBuffer->setResidency(graphics::Residency::KEEP);
+            indexBuffer->initFromBuffer(graphics::Buffer::Usage::INDEX, skeleton->getIndices().data(),
+                                        static_cast<uint32_t>(getVectorSize(skeleton->getIndices())), false);
+
+            vertexBuffer = std::make_shared<graphics::Buffer>();
+            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, true);
+
+            meshBuffer = std::make_shared<graphics::MeshBuffer>();
+            meshBuffer->init(sizeof(uint16_t), indexBuffer, graphics::VertexPCT::ATTRIBUTES, vertexBuffer);
+
+            updatePose();
+            updateMemoryUsage();
+        }
+
+        void SkinnedMesh::updateMemoryUsage()
+        {
+            size_t newMemorySize = pose.capacity() * sizeof(Skeleton::BonePose) +
+                (channelValues.capacity() + channelWeights.capacity() + skinMatrices.capacity()) * sizeof(float) +
+                vertices.capacity() * sizeof(graphics::VertexPCT);
+
+            MemoryTracker::update(MemoryTracker::Tag::SCENE, memorySize, newMemorySize);
+        }
+
+        uint32_t SkinnedMesh::addClip(const std::shared_ptr<AnimationClip>& clip, float weight, bool repeat)
+        {
+            PlayingClip playingClip;
+            playingClip.clip = clip;
+            playingClip.weight = weight;
+            playingClip.time = 0.0f;
+            playingClip.repeat = repeat;
+            playingClip.cursors.resize(clip ? clip->getTracks().size() : 0, 0);
+            clips.push_back(playingClip);
+            poseDirty = true;
+
+            return static_cast<uint32_t>(clips.size() - 1);
+        }
+
+        void SkinnedMesh::removeClip(uint32_t index)
+        {
+            if (index < clips.size())
+            {
+                clips.erase(clips.begin() + index);
+                poseDirty = true;
+            }
+        }
+
+        void SkinnedMesh::removeAllClips()
+        {
+            clips.clear();
+            poseDirty = true;
+        }
+
+        void SkinnedMesh::setClipWeight(uint32_t index, float weight)
+        {
+            if (index < clips.size())
+            {
+                clips[index].weight = weight;
+                poseDirty = true;
+            }
+        }
+
+        float SkinnedMesh::getClipWeight(uint32_t index) const
+        {
+            return (index < clips.size()) ? clips[index].weight : 0.0f;
+        }
+
+        void SkinnedMesh::setClipTime(uint32_t index, float time)
+        {
+            if (index < clips.size())
+            {
+                clips[index].time = time;
+                poseDirty = true;
+            }
+        }
+
+        float SkinnedMesh::getClipTime(uint32_t index) const
+        {
+            return (index < clips.size()) ? clips[index].time : 0.0f;
+        }
+
+        void SkinnedMesh::update(float delta)
+        {
+            if (!skeleton)
+            {
+                return;
+            }
+
+            // the skeleton was changed after the mesh was created
+            if (skeletonVersion != skeleton->getVersion())
+            {
+                createMesh();
+            }
+
+            for (PlayingClip& playingClip : clips)
+            {
+                if (!playingClip.clip) continue;
+
+                float length = playingClip.clip->getLength();
+                float previousTime = playingClip.time;
+                playingClip.time += delta * speed;
+
+                if (playingClip.repeat && length > 0.0f)
+                {
+                    playingClip.time = fmodf(playingClip.time, length);
+                    if (playingClip.time < 0.0f) playingClip.time += length;
+                }
+                else if (playingClip.time > length)
+                {
+                    playingClip.time = length;
+                }
+
+                if (playingClip.time != previousTime && playingClip.weight > 0.0f) poseDirty = true;
+            }
+
+            // skinning is skipped while no clip moves the pose
+            if (poseDirty) updatePose();
+        }
+
+        void SkinnedMesh::updatePose()
+        {
+            poseDirty = false;
+
+            const std::vector<Skeleton::Bone>& bones = skeleton->getBones();
+            uint32_t boneCount = static_cast<uint32_t>(bones.size());
+
+            channelValues.assign(boneCount * CHANNEL_COUNT, 0.0f);
+            channelWeights.assign(boneCount * CHANNEL_COUNT, 0.0f);
+
+            for (PlayingClip& playingClip : clips)
+            {
+                if (!playingClip.clip || playingClip.weight <= 0.0f) continue;
+
+                const std::vector<AnimationClip::Track>& tracks = playingClip.clip->getTracks();
+
+                for (uint32_t i = 0; i < tracks.size(); ++i)
+                {
+                    int32_t channel = getChannel(tracks[i].property);
+
+                    if (channel < 0 || tracks[i].target >= boneCount) continue;
+
+                    uint32_t index = tracks[i].target * CHANNEL_COUNT + static_cast<uint32_t>(channel);
+                    channelValues[index] += playingClip.clip->sample(i, playingClip.time, playingClip.cursors[i]) * playingClip.weight;
+                    channelWeights[index] += playingClip.weight;
+                }
+            }
+
+            for (uint32_t i = 0; i < boneCount; ++i)
+            {
+                const Skeleton::BonePose& bindPose = bones[i].bindPose;
+                float bindValues[CHANNEL_COUNT] = {
+                    bindPose.position.v[0], bindPose.position.v[1],
+                    bindPose.rotation,
+                    bindPose.scale.v[0], bindPose.scale.v[1]
+                };
+
+                float values[CHANNEL_COUNT];
+
+                for (uint32_t channel = 0; channel < CHANNEL_COUNT; ++channel)
+                {
+                    uint32_t index = i * CHANNEL_COUNT + channel;
+                    float weight = channelWeights[index];
+
+                    if (weight < 1.0f)
+                    {
+                        values[channel] = channelValues[index] + bindValues[channel] * (1.0f - weight);
+                    }
+                    else
+                    {
+                        values[channel] = channelValues[index] / weight;
+                    }
+                }
+
+                Skeleton::BonePose& bonePose = pose[i];
+                bonePose.position.set(values[0], values[1]);
+                bonePose.rotation = values[2];
+                bonePose.scale.set(values[3], values[4]);
+            }
+
+            skeleton->computeSkinMatrices(pose, skinMatrices);
+
+            AABB2 meshBoundingBox;
+            skeleton->skin(skinMatrices.data(), vertices.data(), meshBoundingBox);
+
+            boundingBox.reset();
+
+            if (!vertices.empty())
+            {
+                boundingBox.insertPoint(meshBoundingBox.min);
+                boundingBox.insertPoint(meshBoundingBox.max);
+            }
+
+            needsMeshUpload = true;
+            invalidateNode();
+        }
+
+        void SkinnedMesh::draw(const Matrix4& transformMatrix,
+                               const Color& drawColor,
+                               scene::Camera* camera)
+        {
+            Component::draw(transformMatrix, drawColor, camera);
+
+            if (!meshBuffer || vertices.empty())
+            {
+                return;
+            }
+
+            if (needsMeshUpload)
+            {
+                vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+                needsMeshUpload = false;
+            }
+
+            Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix;
+            float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
+
+            FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+            FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+            pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
+
+            FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+            vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
+
+            sharedEngine->getRenderer()->addDrawCommand({skeleton->getTexture()},
+                                                        shader,
+                                                        pixelShaderConstants,
+                                                        vertexShaderConstants,
+                                                        blendState,
+                                                        meshBuffer,
+                                                        indexCount,
+                                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                        0,
+                                                        camera->getRenderTarget(),
+                                                        camera->getRenderViewport(),
+                                                        camera->getDepthWrite(),
+                                                        camera->getDepthTest());
+        }
+
+        void SkinnedMesh::drawWireframe(const Matrix4& transformMatrix,
+                                        const Color& drawColor,
+                                        scene::Camera* camera)
+        {
+            Component::drawWireframe(transformMatrix, drawColor, camera);
+
+            if (!meshBuffer || vertices.empty())
+            {
+                return;
+            }
+
+            Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix;
+            float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
+
+            FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+            FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+            pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
+
+            FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+            vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
+
+            sharedEngine->getRenderer()->addDrawCommand({whitePixelTexture},
+                                                        shader,
+                                                        pixelShaderConstants,
+                                                        vertexShaderConstants,
+                                                        blendState,
+                                                        meshBuffer,
+                                                        indexCount,
+                                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                        0,
+                                                        camera->getRenderTarget(),
+                                                        camera->getRenderViewport(),
+                                                        camera->getDepthWrite(),
+                                                        camera->getDepthTest(),
+                                                        true);
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,106 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "scene/Component.h"
+#include "scene/Skeleton.h"
+#include "animators/AnimationClip.h"
+#include "core/UpdateCallback.h"
+#include "graphics/BlendState.h"
+#include "graphics/Buffer.h"
+#include "graphics/MeshBuffer.h"
+#include "graphics/Shader.h"
+#include "graphics/Texture.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Skinned mesh driven by a blend of animation clips. The tracks of the clips target bones by index,
+        // POSITION_X/Y, ROTATION_Z and SCALE_X/Y are used, other properties are ignored.
+        class SkinnedMesh: public Component
+        {
+        public:
+            SkinnedMesh();
+            SkinnedMesh(const std::shared_ptr<Skeleton>& newSkeleton);
+            virtual ~SkinnedMesh();
+
+            bool init(const std::shared_ptr<Skeleton>& newSkeleton);
+            const std::shared_ptr<Skeleton>& getSkeleton() const { return skeleton; }
+
+            virtual void update(float delta);
+
+            virtual void draw(const Matrix4& transformMatrix,
+                              const Color& drawColor,
+                              scene::Camera* camera) override;
+
+            virtual void drawWireframe(const Matrix4& transformMatrix,
+                                       const Color& drawColor,
+                                       scene::Camera* camera) override;
+
+            virtual const std::shared_ptr<graphics::Shader>& getShader() const { return shader; }
+            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; }
+
+            virtual const std::shared_ptr<graphics::BlendState>& getBlendState() const { return blendState; }
+            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState) { blendState = newBlendState; }
+
+            // clips are blended by weight, while the sum of weights is below 1 the rest comes from the bind pose
+            uint32_t addClip(const std::shared_ptr<AnimationClip>& clip, float weight = 1.0f, bool repeat = true);
+            void removeClip(uint32_t index);
+            void removeAllClips();
+            uint32_t getClipCount() const { return static_cast<uint32_t>(clips.size()); }
+
+            void setClipWeight(uint32_t index, float weight);
+            float getClipWeight(uint32_t index) const;
+            void setClipTime(uint32_t index, float time);
+            float getClipTime(uint32_t index) const;
+
+            void setSpeed(float newSpeed) { speed = newSpeed; }
+            float getSpeed() const { return speed; }
+
+            const std::vector<Skeleton::BonePose>& getPose() const { return pose; }
+
+        protected:
+            struct PlayingClip
+            {
+                std::shared_ptr<AnimationClip> clip;
+                float weight;
+                float time;
+                bool repeat;
+                std::vector<uint32_t> cursors;
+            };
+
+            void createMesh();
+            void updatePose();
+            void updateMemoryUsage();
+
+            std::shared_ptr<graphics::Shader> shader;
+            std::shared_ptr<graphics::BlendState> blendState;
+            std::shared_ptr<graphics::Texture> whitePixelTexture;
+
+            std::shared_ptr<Skeleton> skeleton;
+            uint32_t skeletonVersion = 0;
+            std::vector<PlayingClip> clips;
+            float speed = 1.0f;
+            bool poseDirty = false;
+
+            std::vector<Skeleton::BonePose> pose;
+            std::vector<float> channelValues;
+            std::vector<float> channelWeights;
+            std::vector<float> skinMatrices;
+
+            std::vector<graphics::VertexPCT> vertices;
+            std::shared_ptr<graphics::MeshBuffer> meshBuffer;
+            std::shared_ptr<graphics::Buffer> indexBuffer;
+            std::shared_ptr<graphics::Buffer> vertexBuffer;
+            uint32_t indexCount = 0;
+            bool needsMeshUpload = false;
+            size_t memorySize = 0;
+
+            UpdateCallback updateCallback;
+        };
+    } // namespace scene
+} // namespace ouzel
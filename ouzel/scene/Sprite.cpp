@@ -15,6 +15,7 @@
 #include "SceneManager.h"
 #include "files/FileSystem.h"
 #include "Layer.h"
+#include "StaticBatch.h"
 #include "core/Cache.h"
 
 namespace ouzel
@@ -77,6 +78,7 @@ namespace ouzel
         {
             if (playing)
             {
+                uint32_t previousFrame = currentFrame;
                 timeSinceLastFrame += delta;
 
                 while (timeSinceLastFrame > fabsf(frameInterval))
@@ -121,7 +123,10 @@ namespace ouzel
                     }
                 }
 
-                updateBoundingBox();
+                if (currentFrame != previousFrame)
+                {
+                    updateBoundingBox();
+                }
             }
         }
 
@@ -136,11 +141,13 @@ namespace ouzel
                 Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix * offsetMatrix;
                 float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
 
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+                FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
 
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+                FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
+
+                FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
 
                 sharedEngine->getRenderer()->addDrawCommand({frames[currentFrame].getTexture()},
                                                             shader,
@@ -169,11 +176,13 @@ namespace ouzel
                 Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix * offsetMatrix;
                 float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
 
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+                FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+                FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
 
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+                FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
 
                 sharedEngine->getRenderer()->addDrawCommand({whitePixelTexture},
                                                             shader,
@@ -192,6 +201,33 @@ namespace ouzel
             }
         }
 
+        bool Sprite::bake(const Matrix4& transformMatrix,
+                          const Color& drawColor,
+                          StaticBatch& staticBatch) const
+        {
+            if (shader != sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE))
+            {
+                return false;
+            }
+
+            if (currentFrame < frames.size())
+            {
+                const SpriteFrame& frame = frames[currentFrame];
+
+                staticBatch.addGeometry(frame.getTexture(),
+                                        blendState,
+                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                        frame.getIndices(),
+                                        0,
+                                        static_cast<uint32_t>(frame.getIndices().size()),
+                                        frame.getVertices(),
+                                        transformMatrix * offsetMatrix,
+                                        drawColor);
+            }
+
+            return true;
+        }
+
         void Sprite::setOffset(const Vector2& newOffset)
         {
             offset = newOffset;
@@ -288,6 +324,8 @@ namespace ouzel
                 size.v[0] = size.v[1] = 0.0f;
                 boundingBox.reset();
             }
+
+            invalidateNode();
         }
     } // namespace scene
 } // namespace ouzel
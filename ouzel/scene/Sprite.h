@@ -38,11 +38,15 @@ namespace ouzel
                                        const Color& drawColor,
                                        scene::Camera* camera) override;
 
+            virtual bool bake(const Matrix4& transformMatrix,
+                              const Color& drawColor,
+                              StaticBatch& staticBatch) const override;
+
             virtual const std::shared_ptr<graphics::Shader>& getShader() const { return shader; }
-            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; }
+            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; invalidateNode(); }
 
             virtual const std::shared_ptr<graphics::BlendState>& getBlendState() const { return blendState; }
-            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; }
+            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; invalidateNode(); }
 
             virtual const Size2& getSize() const { return size; }
 
@@ -136,7 +136,7 @@ namespace ouzel
         {
             texture = pTexture;
 
-            std::vector<uint16_t> indices = {0, 1, 2, 1, 3, 2};
+            indices = {0, 1, 2, 1, 3, 2};
 
             Vector2 textCoords[4];
             Vector2 finalOffset(-sourceSize.v[0] * pivot.x() + sourceOffset.x(),
@@ -171,7 +171,7 @@ namespace ouzel
                 textCoords[3] = Vector2(rightBottom.x(), rightBottom.y());
             }
 
-            std::vector<graphics::VertexPCT> vertices = {
+            vertices = {
                 graphics::VertexPCT(Vector3(finalOffset.x(), finalOffset.y(), 0.0f), Color::WHITE, textCoords[0]),
                 graphics::VertexPCT(Vector3(finalOffset.x() + frameRectangle.size.v[0], finalOffset.y(), 0.0f), Color::WHITE, textCoords[1]),
                 graphics::VertexPCT(Vector3(finalOffset.x(), finalOffset.y() + frameRectangle.size.v[1], 0.0f),  Color::WHITE, textCoords[2]),
@@ -184,6 +184,7 @@ namespace ouzel
                                   sourceSize.v[0], sourceSize.v[1]);
 
             indexBuffer = std::make_shared<graphics::Buffer>();
+            indexBuffer->setResidency(graphics::Residency::KEEP);
             indexBuffer->initFromBuffer(graphics::Buffer::Usage::INDEX, indices.data(), static_cast<uint32_t>(getVectorSize(indices)), false);
 
             vertexBuffer = std::make_shared<graphics::Buffer>();
@@ -194,12 +195,14 @@ namespace ouzel
         }
 
         SpriteFrame::SpriteFrame(const std::shared_ptr<graphics::Texture>& pTexture,
-                                 const std::vector<uint16_t>& indices,
-                                 const std::vector<graphics::VertexPCT>& vertices,
+                                 const std::vector<uint16_t>& frameIndices,
+                                 const std::vector<graphics::VertexPCT>& frameVertices,
                                  const Rectangle& frameRectangle,
                                  const Size2& sourceSize,
                                  const Vector2& sourceOffset,
-                                 const Vector2& pivot)
+                                 const Vector2& pivot):
+            indices(frameIndices),
+            vertices(frameVertices)
         {
             texture = pTexture;
 
@@ -215,6 +218,7 @@ namespace ouzel
                                   sourceSize.v[0], sourceSize.v[1]);
 
             indexBuffer = std::make_shared<graphics::Buffer>();
+            indexBuffer->setResidency(graphics::Residency::KEEP);
             indexBuffer->initFromBuffer(graphics::Buffer::Usage::INDEX, indices.data(), static_cast<uint32_t>(getVectorSize(indices)), false);
 
             vertexBuffer = std::make_shared<graphics::Buffer>();
@@ -31,8 +31,8 @@ namespace ouzel
                         const Vector2& pivot);
 
             SpriteFrame(const std::shared_ptr<graphics::Texture>& pTexture,
-                        const std::vector<uint16_t>& indices,
-                        const std::vector<graphics::VertexPCT>& vertices,
+                        const std::vector<uint16_t>& frameIndices,
+                        const std::vector<graphics::VertexPCT>& frameVertices,
                         const Rectangle& frameRectangle,
                         const Size2& sourceSize,
                         const Vector2& sourceOffset,
@@ -44,6 +44,9 @@ namespace ouzel
             const std::shared_ptr<graphics::MeshBuffer>& getMeshBuffer() const { return meshBuffer; }
             const std::shared_ptr<graphics::Texture>& getTexture() const { return texture; }
 
+            const std::vector<uint16_t>& getIndices() const { return indices; }
+            const std::vector<graphics::VertexPCT>& getVertices() const { return vertices; }
+
         protected:
             Rectangle rectangle;
             AABB2 boundingBox;
@@ -51,6 +54,9 @@ namespace ouzel
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
             std::shared_ptr<graphics::Texture> texture;
+
+            std::vector<uint16_t> indices;
+            std::vector<graphics::VertexPCT> vertices;
         };
     } // scene
 } // ouzel
@@ -0,0 +1,347 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <limits>
+#include "StaticBatch.h"
+#include "Component.h"
+#include "Camera.h"
+#include "core/Engine.h"
+#include "core/Cache.h"
+#include "utils/MemoryTracker.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static const uint32_t MAX_BATCH_VERTICES = std::numeric_limits<uint16_t>::max() + 1;
+
+        static inline Color multiplyColor(const Color& a, const Color& b)
+        {
+            return Color(static_cast<uint8_t>(a.v[0] * b.v[0] / 255),
+                         static_cast<uint8_t>(a.v[1] * b.v[1] / 255),
+                         static_cast<uint8_t>(a.v[2] * b.v[2] / 255),
+                         static_cast<uint8_t>(a.v[3] * b.v[3] / 255));
+        }
+
+        StaticBatch::StaticBatch()
+        {
+            shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
+        }
+
+        StaticBatch::~StaticBatch()
+        {
+            MemoryTracker::update(MemoryTracker::Tag::SCENE, memorySize, 0);
+        }
+
+        void StaticBatch::clear()
+        {
+            batches.clear();
+            boundingBox.reset();
+            unbounded = false;
+
+            updateMemoryUsage();
+        }
+
+        void StaticBatch::addGeometry(const std::shared_ptr<graphics::Texture>& texture,
+                                      const std::shared_ptr<graphics::BlendState>& blendState,
+                                      graphics::Renderer::DrawMode drawMode,
+                                      const std::vector<uint16_t>& indices,
+                                      uint32_t startIndex,
+                                      uint32_t indexCount,
+                                      const std::vector<graphics::VertexPCT>& vertices,
+                                      const Matrix4& transformMatrix,
+                                      const Color& drawColor)
+        {
+            if (indexCount == 0 || startIndex + indexCount > indices.size())
+            {
+                return;
+            }
+
+            auto indicesBegin = indices.begin() + startIndex;
+            auto indicesEnd = indicesBegin + indexCount;
+
+            uint16_t firstVertex = *std::min_element(indicesBegin, indicesEnd);
+            uint16_t lastVertex = *std::max_element(indicesBegin, indicesEnd);
+
+            if (lastVertex >= vertices.size())
+            {
+                return;
+            }
+
+            std::vector<graphics::VertexPCT> batchVertices(vertices.begin() + firstVertex,
+                                                           vertices.begin() + lastVertex + 1);
+            AABB3 geometryBoundingBox;
+
+            for (graphics::VertexPCT& vertex : batchVertices)
+            {
+                transformMatrix.transformPoint(vertex.position);
+                vertex.color = multiplyColor(vertex.color, drawColor);
+                geometryBoundingBox.insertPoint(vertex.position);
+            }
+
+            // strips are converted to lists, so that geometry of different components can share one draw call
+            std::vector<uint16_t> batchIndices;
+
+            switch (drawMode)
+            {
+                case graphics::Renderer::DrawMode::LINE_STRIP:
+                    drawMode = graphics::Renderer::DrawMode::LINE_LIST;
+
+                    for (uint32_t i = 1; i < indexCount; ++i)
+                    {
+                        batchIndices.push_back(indicesBegin[i - 1]);
+                        batchIndices.push_back(indicesBegin[i]);
+                    }
+                    break;
+                case graphics::Renderer::DrawMode::TRIANGLE_STRIP:
+                    drawMode = graphics::Renderer::DrawMode::TRIANGLE_LIST;
+
+                    for (uint32_t i = 2; i < indexCount; ++i)
+                    {
+                        if (i % 2)
+                        {
+                            batchIndices.push_back(indicesBegin[i - 1]);
+                            batchIndices.push_back(indicesBegin[i - 2]);
+                        }
+                        else
+                        {
+                            batchIndices.push_back(indicesBegin[i - 2]);
+                            batchIndices.push_back(indicesBegin[i - 1]);
+                        }
+
+                        batchIndices.push_back(indicesBegin[i]);
+                    }
+                    break;
+                default:
+                    batchIndices.assign(indicesBegin, indicesEnd);
+                    break;
+            }
+
+            Batch& batch = getBatch(texture, blendState, drawMode,
+                                    static_cast<uint32_t>(batchVertices.size()),
+                                    geometryBoundingBox);
+
+            uint32_t baseVertex = static_cast<uint32_t>(batch.vertices.size());
+
+            for (uint16_t index : batchIndices)
+            {
+                batch.indices.push_back(static_cast<uint16_t>(baseVertex + index - firstVertex));
+            }
+
+            batch.vertices.insert(batch.vertices.end(), batchVertices.begin(), batchVertices.end());
+            batch.boundingBox.merge(geometryBoundingBox);
+            boundingBox.merge(geometryBoundingBox);
+        }
+
+        void StaticBatch::addGeometry(const std::shared_ptr<graphics::BlendState>& blendState,
+                                      graphics::Renderer::DrawMode drawMode,
+                                      const std::vector<uint16_t>& indices,
+                                      uint32_t startIndex,
+                                      uint32_t indexCount,
+                                      const std::vector<graphics::VertexPC>& vertices,
+                                      const Matrix4& transformMatrix,
+                                      const Color& drawColor)
+        {
+            if (indexCount == 0 || startIndex + indexCount > indices.size())
+            {
+                return;
+            }
+
+            auto indicesBegin = indices.begin() + startIndex;
+            auto indicesEnd = indicesBegin + indexCount;
+
+            uint16_t firstVertex = *std::min_element(indicesBegin, indicesEnd);
+            uint16_t lastVertex = *std::max_element(indicesBegin, indicesEnd);
+
+            if (lastVertex >= vertices.size())
+            {
+                return;
+            }
+
+            std::vector<uint16_t> texturedIndices;
+            texturedIndices.reserve(indexCount);
+
+            for (auto i = indicesBegin; i != indicesEnd; ++i)
+            {
+                texturedIndices.push_back(static_cast<uint16_t>(*i - firstVertex));
+            }
+
+            std::vector<graphics::VertexPCT> texturedVertices;
+            texturedVertices.reserve(lastVertex - firstVertex + 1);
+
+            for (uint32_t i = firstVertex; i <= lastVertex; ++i)
+            {
+                texturedVertices.push_back(graphics::VertexPCT(vertices[i].position, vertices[i].color, Vector2()));
+            }
+
+            addGeometry(whitePixelTexture, blendState, drawMode,
+                        texturedIndices, 0, indexCount,
+                        texturedVertices, transformMatrix, drawColor);
+        }
+
+        void StaticBatch::addComponent(Component* component,
+                                       const Matrix4& transformMatrix,
+                                       const Color& drawColor)
+        {
+            Batch batch;
+            batch.component = component;
+            batch.transform = transformMatrix;
+            batch.color = drawColor;
+
+            const AABB3& componentBoundingBox = component->getBoundingBox();
+
+            if (componentBoundingBox.isEmpty())
+            {
+                // unknown extents, nothing can be moved across this component
+                batch.boundingBox = AABB3(Vector3(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()),
+                                          Vector3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()));
+
+                // the batch can't be culled by its bounding box anymore
+                unbounded = true;
+            }
+            else
+            {
+                Vector3 corners[8];
+                componentBoundingBox.getCorners(corners);
+
+                for (Vector3& corner : corners)
+                {
+                    transformMatrix.transformPoint(corner);
+                    batch.boundingBox.insertPoint(corner);
+                }
+
+                boundingBox.merge(batch.boundingBox);
+            }
+
+            batches.push_back(batch);
+        }
+
+        void StaticBatch::upload()
+        {
+            for (Batch& batch : batches)
+            {
+                if (!batch.component && !batch.meshBuffer)
+                {
+                    std::shared_ptr<graphics::Buffer> indexBuffer = std::make_shared<graphics::Buffer>();
+                    indexBuffer->setResidency(graphics::Residency::KEEP);
+                    indexBuffer->initFromBuffer(graphics::Buffer::Usage::INDEX, batch.indices.data(), static_cast<uint32_t>(getVectorSize(batch.indices)), false);
+
+                    std::shared_ptr<graphics::Buffer> vertexBuffer = std::make_shared<graphics::Buffer>();
+                    vertexBuffer->setResidency(graphics::Residency::KEEP);
+                    vertexBuffer->initFromBuffer(graphics::Buffer::Usage::VERTEX, batch.vertices.data(), static_cast<uint32_t>(getVectorSize(batch.vertices)), false);
+
+                    batch.meshBuffer = std::make_shared<graphics::MeshBuffer>();
+                    batch.meshBuffer->init(sizeof(uint16_t), indexBuffer, graphics::VertexPCT::ATTRIBUTES, vertexBuffer);
+
+                    batch.indexCount = static_cast<uint32_t>(batch.indices.size());
+
+                    // the buffers keep the only copy, so that they can be reloaded
+                    std::vector<uint16_t>().swap(batch.indices);
+                    std::vector<graphics::VertexPCT>().swap(batch.vertices);
+                }
+            }
+
+            updateMemoryUsage();
+        }
+
+        void StaticBatch::draw(const Matrix4& transformMatrix,
+                               Camera* camera,
+                               bool wireframe)
+        {
+            Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix;
+            float colorVector[] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+            for (const Batch& batch : batches)
+            {
+                if (batch.component)
+                {
+                    if (wireframe)
+                    {
+                        Color wireframeColor(batch.color.v[0], batch.color.v[1], batch.color.v[2], 255);
+                        batch.component->drawWireframe(transformMatrix * batch.transform, wireframeColor, camera);
+                    }
+                    else
+                    {
+                        batch.component->draw(transformMatrix * batch.transform, batch.color, camera);
+                    }
+                }
+                else if (batch.meshBuffer)
+                {
+                    FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+                    FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+                    pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
+
+                    FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+                    vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
+
+                    sharedEngine->getRenderer()->addDrawCommand({wireframe ? whitePixelTexture : batch.texture},
+                                                                shader,
+                                                                pixelShaderConstants,
+                                                                vertexShaderConstants,
+                                                                batch.blendState,
+                                                                batch.meshBuffer,
+                                                                batch.indexCount,
+                                                                batch.drawMode,
+                                                                0,
+                                                                camera->getRenderTarget(),
+                                                                camera->getRenderViewport(),
+                                                                camera->getDepthWrite(),
+                                                                camera->getDepthTest(),
+                                                                wireframe);
+                }
+            }
+        }
+
+        StaticBatch::Batch& StaticBatch::getBatch(const std::shared_ptr<graphics::Texture>& texture,
+                                                  const std::shared_ptr<graphics::BlendState>& blendState,
+                                                  graphics::Renderer::DrawMode drawMode,
+                                                  uint32_t vertexCount,
+                                                  const AABB3& geometryBoundingBox)
+        {
+            // geometry can be merged into an earlier batch only if it doesn't overlap anything drawn in between
+            for (auto i = batches.rbegin(); i != batches.rend(); ++i)
+            {
+                Batch& batch = *i;
+
+                if (!batch.component &&
+                    !batch.meshBuffer &&
+                    batch.texture == texture &&
+                    batch.blendState == blendState &&
+                    batch.drawMode == drawMode &&
+                    batch.vertices.size() + vertexCount <= MAX_BATCH_VERTICES)
+                {
+                    return batch;
+                }
+
+                if (batch.boundingBox.intersects(geometryBoundingBox))
+                {
+                    break;
+                }
+            }
+
+            Batch batch;
+            batch.texture = texture;
+            batch.blendState = blendState;
+            batch.drawMode = drawMode;
+            batches.push_back(batch);
+
+            return batches.back();
+        }
+
+        void StaticBatch::updateMemoryUsage()
+        {
+            size_t newMemorySize = batches.capacity() * sizeof(Batch);
+
+            for (const Batch& batch : batches)
+            {
+                newMemorySize += batch.indices.capacity() * sizeof(uint16_t) + batch.vertices.capacity() * sizeof(graphics::VertexPCT);
+            }
+
+            MemoryTracker::update(MemoryTracker::Tag::SCENE, memorySize, newMemorySize);
+        }
+    } // namespace scene
+} // namespace ouzel
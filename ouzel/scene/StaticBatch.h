@@ -0,0 +1,102 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include "utils/Noncopyable.h"
+#include "math/AABB3.h"
+#include "math/Color.h"
+#include "math/Matrix4.h"
+#include "graphics/Renderer.h"
+#include "graphics/Vertex.h"
+#include "graphics/BlendState.h"
+#include "graphics/Buffer.h"
+#include "graphics/MeshBuffer.h"
+#include "graphics/Shader.h"
+#include "graphics/Texture.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Camera;
+        class Component;
+
+        class StaticBatch: public Noncopyable
+        {
+        public:
+            StaticBatch();
+            ~StaticBatch();
+
+            void clear();
+
+            void addGeometry(const std::shared_ptr<graphics::Texture>& texture,
+                             const std::shared_ptr<graphics::BlendState>& blendState,
+                             graphics::Renderer::DrawMode drawMode,
+                             const std::vector<uint16_t>& indices,
+                             uint32_t startIndex,
+                             uint32_t indexCount,
+                             const std::vector<graphics::VertexPCT>& vertices,
+                             const Matrix4& transformMatrix,
+                             const Color& drawColor);
+
+            void addGeometry(const std::shared_ptr<graphics::BlendState>& blendState,
+                             graphics::Renderer::DrawMode drawMode,
+                             const std::vector<uint16_t>& indices,
+                             uint32_t startIndex,
+                             uint32_t indexCount,
+                             const std::vector<graphics::VertexPC>& vertices,
+                             const Matrix4& transformMatrix,
+                             const Color& drawColor);
+
+            void addComponent(Component* component,
+                              const Matrix4& transformMatrix,
+                              const Color& drawColor);
+
+            void upload();
+
+            void draw(const Matrix4& transformMatrix,
+                      Camera* camera,
+                      bool wireframe);
+
+            const AABB3& getBoundingBox() const { return boundingBox; }
+            bool isUnbounded() const { return unbounded; }
+            uint32_t getBatchCount() const { return static_cast<uint32_t>(batches.size()); }
+
+        protected:
+            struct Batch
+            {
+                std::shared_ptr<graphics::Texture> texture;
+                std::shared_ptr<graphics::BlendState> blendState;
+                graphics::Renderer::DrawMode drawMode = graphics::Renderer::DrawMode::TRIANGLE_LIST;
+
+                Component* component = nullptr;
+                Matrix4 transform;
+                Color color;
+
+                AABB3 boundingBox;
+                std::vector<uint16_t> indices;
+                std::vector<graphics::VertexPCT> vertices;
+                uint32_t indexCount = 0;
+
+                std::shared_ptr<graphics::MeshBuffer> meshBuffer;
+            };
+
+            Batch& getBatch(const std::shared_ptr<graphics::Texture>& texture,
+                            const std::shared_ptr<graphics::BlendState>& blendState,
+                            graphics::Renderer::DrawMode drawMode,
+                            uint32_t vertexCount,
+                            const AABB3& geometryBoundingBox);
+            void updateMemoryUsage();
+
+            std::shared_ptr<graphics::Shader> shader;
+            std::shared_ptr<graphics::Texture> whitePixelTexture;
+
+            std::vector<Batch> batches;
+            AABB3 boundingBox;
+            bool unbounded = false;
+            size_t memorySize = 0;
+        };
+    } // namespace scene
+} // namespace ouzel
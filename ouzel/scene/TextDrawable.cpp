@@ -5,7 +5,9 @@
 #include "core/Engine.h"
 #include "graphics/Renderer.h"
 #include "scene/Camera.h"
+#include "scene/StaticBatch.h"
 #include "core/Cache.h"
+#include "utils/MemoryTracker.h"
 #include "utils/Utils.h"
 
 namespace ouzel
@@ -39,6 +41,11 @@ namespace ouzel
             updateText();
         }
 
+        TextDrawable::~TextDrawable()
+        {
+            MemoryTracker::update(MemoryTracker::Tag::GUI, memorySize, 0);
+        }
+
         void TextDrawable::setFont(const std::string& fontFile)
         {
             font = sharedEngine->getCache()->getBMFont(fontFile);
@@ -71,11 +78,13 @@ namespace ouzel
             Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix;
             float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
 
-            std::vector<std::vector<float>> pixelShaderConstants(1);
-            pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+            FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
+
+            FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+            pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
 
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+            FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+            vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
 
             sharedEngine->getRenderer()->addDrawCommand({texture},
                                                         shader,
@@ -101,11 +110,13 @@ namespace ouzel
             Matrix4 modelViewProj = camera->getRenderViewProjection() * transformMatrix;
             float colorVector[] = {drawColor.normR(), drawColor.normG(), drawColor.normB(), drawColor.normA()};
 
-            std::vector<std::vector<float>> pixelShaderConstants(1);
-            pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+            FrameAllocator* frameAllocator = sharedEngine->getFrameAllocator();
 
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+            FrameVector<FrameVector<float>> pixelShaderConstants(frameAllocator);
+            pixelShaderConstants.emplace_back(std::begin(colorVector), std::end(colorVector), frameAllocator);
+
+            FrameVector<FrameVector<float>> vertexShaderConstants(frameAllocator);
+            vertexShaderConstants.emplace_back(std::begin(modelViewProj.m), std::end(modelViewProj.m), frameAllocator);
 
             sharedEngine->getRenderer()->addDrawCommand({whitePixelTexture},
                                                         shader,
@@ -123,6 +134,28 @@ namespace ouzel
                                                         true);
         }
 
+        bool TextDrawable::bake(const Matrix4& transformMatrix,
+                                const Color& drawColor,
+                                StaticBatch& staticBatch) const
+        {
+            if (shader != sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE))
+            {
+                return false;
+            }
+
+            staticBatch.addGeometry(texture,
+                                    blendState,
+                                    graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                    indices,
+                                    0,
+                                    static_cast<uint32_t>(indices.size()),
+                                    vertices,
+                                    transformMatrix,
+                                    drawColor);
+
+            return true;
+        }
+
         void TextDrawable::setText(const std::string& newText)
         {
             text = newText;
@@ -142,6 +175,9 @@ namespace ouzel
             font.getVertices(text, color, textAnchor, indices, vertices);
             needsMeshUpdate = true;
 
+            MemoryTracker::update(MemoryTracker::Tag::GUI, memorySize,
+                                  indices.capacity() * sizeof(uint16_t) + vertices.capacity() * sizeof(graphics::VertexPCT));
+
             boundingBox.reset();
 
             for (const graphics::VertexPCT& vertex : vertices)
@@ -149,6 +185,7 @@ namespace ouzel
                 boundingBox.insertPoint(Vector2(vertex.position.v[0], vertex.position.v[1]));
             }
 
+            invalidateNode();
         }
     } // namespace scene
 } // namespace ouzel
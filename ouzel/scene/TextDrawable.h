@@ -25,6 +25,7 @@ namespace ouzel
                          bool aMipmaps = true,
                          const std::string& aText = std::string(),
                          const Vector2& aTextAnchor = Vector2(0.5f, 0.5f));
+            virtual ~TextDrawable();
 
             virtual void draw(const Matrix4& transformMatrix,
                               const Color& drawColor,
@@ -34,6 +35,10 @@ namespace ouzel
                                        const Color& drawColor,
                                        scene::Camera* camera) override;
 
+            virtual bool bake(const Matrix4& transformMatrix,
+                              const Color& drawColor,
+                              StaticBatch& staticBatch) const override;
+
             virtual void setFont(const std::string& fontFile);
 
             virtual void setTextAnchor(const Vector2& newTextAnchor);
@@ -46,10 +51,10 @@ namespace ouzel
             virtual void setColor(const Color& newColor);
 
             virtual const std::shared_ptr<graphics::Shader>& getShader() const { return shader; }
-            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; }
+            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; invalidateNode(); }
 
             virtual const std::shared_ptr<graphics::BlendState>& getBlendState() const { return blendState; }
-            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; }
+            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; invalidateNode(); }
 
         protected:
             void updateText();
@@ -75,6 +80,7 @@ namespace ouzel
 
             bool mipmaps = true;
             bool needsMeshUpdate = false;
+            size_t memorySize = 0;
         };
     } // namespace scene
 } // namespace ouzel
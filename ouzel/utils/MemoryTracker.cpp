@@ -0,0 +1,156 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <atomic>
+#include <cstdio>
+#include "MemoryTracker.h"
+#include "utils/Log.h"
+
+namespace ouzel
+{
+    struct Counters
+    {
+        std::atomic<uint64_t> liveSize;
+        std::atomic<uint64_t> peakSize;
+        std::atomic<uint64_t> allocationCount;
+        std::atomic<uint64_t> allocatedSize;
+    };
+
+    // zero initialized before any constructor runs, so resources that are created or destroyed by static objects are counted too
+    static Counters counters[MemoryTracker::TAG_COUNT];
+
+    // only touched by the update thread
+    static uint64_t rateStartSizes[MemoryTracker::TAG_COUNT];
+    static float rateTime = 0.0f;
+    static std::atomic<float> allocationRates[MemoryTracker::TAG_COUNT];
+
+    const char* MemoryTracker::getTagName(Tag tag)
+    {
+        switch (tag)
+        {
+            case Tag::GRAPHICS: return "graphics";
+            case Tag::GPU: return "GPU (estimated)";
+            case Tag::AUDIO: return "audio";
+            case Tag::SCENE: return "scene";
+            case Tag::CACHE: return "cache";
+            case Tag::GUI: return "GUI";
+        }
+
+        return "";
+    }
+
+    void MemoryTracker::allocate(Tag tag, size_t size)
+    {
+        if (!size) return;
+
+        Counters& tagCounters = counters[static_cast<uint32_t>(tag)];
+
+        uint64_t liveSize = tagCounters.liveSize.fetch_add(size, std::memory_order_relaxed) + size;
+        ++tagCounters.allocationCount;
+        tagCounters.allocatedSize.fetch_add(size, std::memory_order_relaxed);
+
+        uint64_t peakSize = tagCounters.peakSize.load(std::memory_order_relaxed);
+        while (liveSize > peakSize &&
+               !tagCounters.peakSize.compare_exchange_weak(peakSize, liveSize, std::memory_order_relaxed));
+    }
+
+    void MemoryTracker::deallocate(Tag tag, size_t size)
+    {
+        if (!size) return;
+
+        counters[static_cast<uint32_t>(tag)].liveSize.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::update(Tag tag, size_t& trackedSize, size_t newSize)
+    {
+        if (newSize > trackedSize)
+        {
+            allocate(tag, newSize - trackedSize);
+        }
+        else if (newSize < trackedSize)
+        {
+            deallocate(tag, trackedSize - newSize);
+        }
+
+        trackedSize = newSize;
+    }
+
+    size_t MemoryTracker::getLiveSize(Tag tag)
+    {
+        return static_cast<size_t>(counters[static_cast<uint32_t>(tag)].liveSize.load());
+    }
+
+    size_t MemoryTracker::getPeakSize(Tag tag)
+    {
+        return static_cast<size_t>(counters[static_cast<uint32_t>(tag)].peakSize.load());
+    }
+
+    uint64_t MemoryTracker::getAllocationCount(Tag tag)
+    {
+        return counters[static_cast<uint32_t>(tag)].allocationCount.load();
+    }
+
+    uint64_t MemoryTracker::getAllocatedSize(Tag tag)
+    {
+        return counters[static_cast<uint32_t>(tag)].allocatedSize.load();
+    }
+
+    float MemoryTracker::getAllocationRate(Tag tag)
+    {
+        return allocationRates[static_cast<uint32_t>(tag)].load();
+    }
+
+    void MemoryTracker::resetPeaks()
+    {
+        for (Counters& tagCounters : counters)
+        {
+            tagCounters.peakSize = tagCounters.liveSize.load();
+        }
+    }
+
+    void MemoryTracker::updateAllocationRates(float delta)
+    {
+        rateTime += delta;
+
+        if (rateTime >= 1.0f)
+        {
+            for (uint32_t i = 0; i < TAG_COUNT; ++i)
+            {
+                uint64_t allocatedSize = counters[i].allocatedSize.load();
+                allocationRates[i] = static_cast<float>(allocatedSize - rateStartSizes[i]) / rateTime;
+                rateStartSizes[i] = allocatedSize;
+            }
+
+            rateTime = 0.0f;
+        }
+    }
+
+    std::string MemoryTracker::getReport()
+    {
+        std::string report = "Memory usage:\n";
+        char line[256];
+
+        snprintf(line, sizeof(line), "%-16s %12s %12s %14s %14s\n", "tag", "live KiB", "peak KiB", "allocations", "KiB/s");
+        report += line;
+
+        for (uint32_t i = 0; i < TAG_COUNT; ++i)
+        {
+            Tag tag = static_cast<Tag>(i);
+
+            snprintf(line, sizeof(line), "%-16s %12.1f %12.1f %14llu %14.1f\n",
+                     getTagName(tag),
+                     getLiveSize(tag) / 1024.0,
+                     getPeakSize(tag) / 1024.0,
+                     static_cast<unsigned long long>(getAllocationCount(tag)),
+                     getAllocationRate(tag) / 1024.0);
+            report += line;
+        }
+
+        return report;
+    }
+
+    void MemoryTracker::logReport()
+    {
+        Log(Log::Level::INFO) << getReport();
+    }
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ouzel
+{
+    // Counts the memory used by the subsystems of the engine. The owners of the big buffers (texture levels, vertex
+    // data, PCM samples, particles...) report the changes of their sizes, so the counters are cheap enough to be always
+    // on, but small allocations are not counted. All functions can be called from any thread.
+    class MemoryTracker
+    {
+    public:
+        enum class Tag
+        {
+            GRAPHICS, // CPU copies of textures and buffers
+            GPU, // estimated size of the textures and buffers in video memory
+            AUDIO,
+            SCENE,
+            CACHE,
+            GUI
+        };
+
+        static const uint32_t TAG_COUNT = 6;
+
+        static const char* getTagName(Tag tag);
+
+        static void allocate(Tag tag, size_t size);
+        static void deallocate(Tag tag, size_t size);
+        // changes the size that is counted for an owner from trackedSize to newSize
+        static void update(Tag tag, size_t& trackedSize, size_t newSize);
+
+        static size_t getLiveSize(Tag tag);
+        static size_t getPeakSize(Tag tag);
+        static uint64_t getAllocationCount(Tag tag);
+        static uint64_t getAllocatedSize(Tag tag);
+        // bytes allocated per second, measured over the last full second
+        static float getAllocationRate(Tag tag);
+        static void resetPeaks();
+
+        // called by the engine once per frame
+        static void updateAllocationRates(float delta);
+
+        static std::string getReport();
+        static void logReport();
+    };
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <atomic>
+#include "ObjectPool.h"
+#include "utils/Log.h"
+
+namespace ouzel
+{
+    ObjectPoolBase::ObjectPoolBase(uint32_t aObjectSize, uint32_t aChunkSize):
+        objectSize(aObjectSize),
+        chunkSize(aChunkSize > 0 ? aChunkSize : 1)
+    {
+        uint32_t size = objectSize > sizeof(FreeSlot) ? objectSize : static_cast<uint32_t>(sizeof(FreeSlot));
+        slotSize = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    ObjectPoolBase::~ObjectPoolBase()
+    {
+        if (liveCount)
+        {
+            Log(Log::Level::WARN) << liveCount << " pooled objects of size " << objectSize << " were not destroyed";
+        }
+    }
+
+    void* ObjectPoolBase::allocate()
+    {
+        uint8_t* slot;
+
+        if (freeList)
+        {
+            slot = reinterpret_cast<uint8_t*>(freeList);
+            freeList = freeList->next;
+            ++reuseCount;
+        }
+        else
+        {
+            if (!freshSlotCount)
+            {
+                std::unique_ptr<uint8_t[]> chunk(new uint8_t[chunkSize * slotSize + ALIGNMENT]);
+
+                uintptr_t address = reinterpret_cast<uintptr_t>(chunk.get());
+                freshSlot = chunk.get() + (ALIGNMENT - address % ALIGNMENT) % ALIGNMENT;
+                freshSlotCount = chunkSize;
+
+                chunks.push_back(std::move(chunk));
+            }
+
+            slot = freshSlot;
+            freshSlot += slotSize;
+            --freshSlotCount;
+        }
+
+        ++allocationCount;
+        if (++liveCount > peakCount) peakCount = liveCount;
+
+        return slot;
+    }
+
+    void ObjectPoolBase::deallocate(void* object)
+    {
+        FreeSlot* freeSlot = static_cast<FreeSlot*>(object);
+        freeSlot->next = freeList;
+        freeList = freeSlot;
+
+        --liveCount;
+        ++releaseCount;
+    }
+
+    uint32_t ObjectPoolBase::getNextTypeId()
+    {
+        static std::atomic<uint32_t> typeCount(0);
+        return typeCount++;
+    }
+}
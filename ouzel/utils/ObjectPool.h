@@ -0,0 +1,121 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    // Stores objects of one size in contiguous chunks and reuses released slots. Pools are not thread safe.
+    class ObjectPoolBase: public Noncopyable
+    {
+    public:
+        static const uint32_t ALIGNMENT = 16;
+
+        ObjectPoolBase(uint32_t aObjectSize, uint32_t aChunkSize);
+        virtual ~ObjectPoolBase();
+
+        void* allocate();
+        void deallocate(void* object);
+
+        static uint32_t getNextTypeId();
+
+        uint32_t getObjectSize() const { return objectSize; }
+        uint32_t getChunkSize() const { return chunkSize; }
+        uint32_t getChunkCount() const { return static_cast<uint32_t>(chunks.size()); }
+        uint32_t getCapacity() const { return chunkSize * static_cast<uint32_t>(chunks.size()); }
+
+        uint32_t getLiveCount() const { return liveCount; }
+        uint32_t getPeakCount() const { return peakCount; }
+        uint64_t getAllocationCount() const { return allocationCount; }
+        uint64_t getReuseCount() const { return reuseCount; }
+        uint64_t getReleaseCount() const { return releaseCount; }
+
+    protected:
+        struct FreeSlot
+        {
+            FreeSlot* next;
+        };
+
+        uint32_t objectSize;
+        uint32_t chunkSize;
+        uint32_t slotSize;
+
+        std::vector<std::unique_ptr<uint8_t[]>> chunks;
+        uint8_t* freshSlot = nullptr;
+        uint32_t freshSlotCount = 0;
+        FreeSlot* freeList = nullptr;
+
+        uint32_t liveCount = 0;
+        uint32_t peakCount = 0;
+        uint64_t allocationCount = 0;
+        uint64_t reuseCount = 0;
+        uint64_t releaseCount = 0;
+    };
+
+    template<class T>
+    class ObjectPool: public ObjectPoolBase
+    {
+    public:
+        static_assert(alignof(T) <= ALIGNMENT, "Object alignment is too big for the pool");
+
+        explicit ObjectPool(uint32_t aChunkSize = 64):
+            ObjectPoolBase(static_cast<uint32_t>(sizeof(T)), aChunkSize)
+        {
+        }
+
+        template<class... Args>
+        T* create(Args&&... args)
+        {
+            return new (allocate()) T(std::forward<Args>(args)...);
+        }
+
+        void destroy(T* object)
+        {
+            if (object)
+            {
+                object->~T();
+                deallocate(object);
+            }
+        }
+    };
+
+    // Deleter of the objects created by Engine::create. It keeps the pool and the address of the object as the created
+    // type, so the object is released correctly also after the handle is converted to a handle of a base class.
+    // The handle must not be reset to another object, release() takes the object out of the pool's management.
+    class PoolDeleter
+    {
+    public:
+        PoolDeleter() {}
+
+        template<class T>
+        PoolDeleter(ObjectPool<T>* aPool, T* aObject):
+            pool(aPool), object(aObject), destroyFunction(&destroyObject<T>)
+        {
+        }
+
+        void operator()(const void*) const
+        {
+            if (pool) destroyFunction(pool, object);
+        }
+
+    private:
+        template<class T>
+        static void destroyObject(ObjectPoolBase* pool, void* object)
+        {
+            static_cast<ObjectPool<T>*>(pool)->destroy(static_cast<T*>(object));
+        }
+
+        ObjectPoolBase* pool = nullptr;
+        void* object = nullptr;
+        void (*destroyFunction)(ObjectPoolBase*, void*) = nullptr;
+    };
+
+    template<class T> using PoolPtr = std::unique_ptr<T, PoolDeleter>;
+}
@@ -0,0 +1,195 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE2
+#include <emmintrin.h>
+#endif
+#include "Random.h"
+#include "Utils.h"
+
+namespace ouzel
+{
+    static const float SIGNED_FLOAT_SCALE = 1.0f / 8388608.0f; // 2^-23
+
+    static inline uint64_t splitMix64(uint64_t& value)
+    {
+        uint64_t z = (value += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    Random::Random(uint64_t aSeed)
+    {
+        setSeed(aSeed);
+    }
+
+    void Random::setSeed(uint64_t newSeed)
+    {
+        seed = newSeed;
+
+        uint64_t value = seed;
+
+        for (uint32_t lane = 0; lane < LANE_COUNT; ++lane)
+        {
+            uint64_t a = splitMix64(value);
+            uint64_t b = splitMix64(value);
+
+            state[0][lane] = static_cast<uint32_t>(a);
+            state[1][lane] = static_cast<uint32_t>(a >> 32);
+            state[2][lane] = static_cast<uint32_t>(b);
+            state[3][lane] = static_cast<uint32_t>(b >> 32);
+
+            // all-zero state would produce only zeros
+            if (!state[0][lane] && !state[1][lane] && !state[2][lane] && !state[3][lane])
+            {
+                state[0][lane] = 1;
+            }
+        }
+
+        bufferPosition = LANE_COUNT;
+    }
+
+    uint32_t Random::getUInt32()
+    {
+        if (bufferPosition == LANE_COUNT)
+        {
+            step(buffer);
+            bufferPosition = 0;
+        }
+
+        return buffer[bufferPosition++];
+    }
+
+    float Random::getFloat()
+    {
+        return static_cast<float>(getUInt32() >> 8) * (SIGNED_FLOAT_SCALE * 0.5f);
+    }
+
+    float Random::getSignedFloat()
+    {
+        return static_cast<float>(getUInt32() >> 8) * SIGNED_FLOAT_SCALE - 1.0f;
+    }
+
+    void Random::getSignedFloats(float* result, uint32_t count)
+    {
+        // drain the buffered values first, so that the bulk and single value calls produce one sequence
+        while (count && bufferPosition < LANE_COUNT)
+        {
+            *result++ = getSignedFloat();
+            --count;
+        }
+
+        uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+        if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+        {
+            uint32x4_t s0 = vld1q_u32(state[0]);
+            uint32x4_t s1 = vld1q_u32(state[1]);
+            uint32x4_t s2 = vld1q_u32(state[2]);
+            uint32x4_t s3 = vld1q_u32(state[3]);
+            float32x4_t scale = vdupq_n_f32(SIGNED_FLOAT_SCALE);
+            float32x4_t one = vdupq_n_f32(1.0f);
+
+            for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+            {
+                uint32x4_t value = vaddq_u32(s0, s3);
+                uint32x4_t t = vshlq_n_u32(s1, 9);
+
+                s2 = veorq_u32(s2, s0);
+                s3 = veorq_u32(s3, s1);
+                s1 = veorq_u32(s1, s2);
+                s0 = veorq_u32(s0, s3);
+                s2 = veorq_u32(s2, t);
+                s3 = vorrq_u32(vshlq_n_u32(s3, 11), vshrq_n_u32(s3, 21));
+
+                float32x4_t f = vcvtq_f32_u32(vshrq_n_u32(value, 8));
+                vst1q_f32(result + i, vsubq_f32(vmulq_f32(f, scale), one));
+            }
+
+            vst1q_u32(state[0], s0);
+            vst1q_u32(state[1], s1);
+            vst1q_u32(state[2], s2);
+            vst1q_u32(state[3], s3);
+        }
+#elif OUZEL_SUPPORTS_SSE2
+        __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state[0]));
+        __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state[1]));
+        __m128i s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state[2]));
+        __m128i s3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state[3]));
+        __m128 scale = _mm_set1_ps(SIGNED_FLOAT_SCALE);
+        __m128 one = _mm_set1_ps(1.0f);
+
+        for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+        {
+            __m128i value = _mm_add_epi32(s0, s3);
+            __m128i t = _mm_slli_epi32(s1, 9);
+
+            s2 = _mm_xor_si128(s2, s0);
+            s3 = _mm_xor_si128(s3, s1);
+            s1 = _mm_xor_si128(s1, s2);
+            s0 = _mm_xor_si128(s0, s3);
+            s2 = _mm_xor_si128(s2, t);
+            s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+            // the top 24 bits fit into a signed integer, so the signed conversion is exact
+            __m128 f = _mm_cvtepi32_ps(_mm_srli_epi32(value, 8));
+            _mm_storeu_ps(result + i, _mm_sub_ps(_mm_mul_ps(f, scale), one));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state[0]), s0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state[1]), s1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state[2]), s2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state[3]), s3);
+#endif
+
+        uint32_t values[LANE_COUNT];
+
+        for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+        {
+            step(values);
+
+            for (uint32_t lane = 0; lane < LANE_COUNT; ++lane)
+            {
+                result[i + lane] = static_cast<float>(values[lane] >> 8) * SIGNED_FLOAT_SCALE - 1.0f;
+            }
+        }
+
+        for (; i < count; ++i)
+        {
+            result[i] = getSignedFloat();
+        }
+    }
+
+    void Random::step(uint32_t* result)
+    {
+        for (uint32_t lane = 0; lane < LANE_COUNT; ++lane)
+        {
+            uint32_t s0 = state[0][lane];
+            uint32_t s1 = state[1][lane];
+            uint32_t s2 = state[2][lane];
+            uint32_t s3 = state[3][lane];
+
+            result[lane] = s0 + s3;
+            uint32_t t = s1 << 9;
+
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = (s3 << 11) | (s3 >> 21);
+
+            state[0][lane] = s0;
+            state[1][lane] = s1;
+            state[2][lane] = s2;
+            state[3][lane] = s3;
+        }
+    }
+}
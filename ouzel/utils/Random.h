@@ -0,0 +1,52 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace ouzel
+{
+    // Four interleaved xoshiro128+ generators, stepped together so that bulk generation can use SIMD.
+    // The sequence depends only on the seed, the same on every platform.
+    // Satisfies UniformRandomBitGenerator, so it can be used with the standard distributions.
+    class Random
+    {
+    public:
+        typedef uint32_t result_type;
+
+        static const uint32_t LANE_COUNT = 4;
+
+        explicit Random(uint64_t aSeed = 0);
+
+        void setSeed(uint64_t newSeed);
+        uint64_t getSeed() const { return seed; }
+
+        uint32_t getUInt32();
+        // uniform float in [0, 1)
+        float getFloat();
+        // uniform float in [-1, 1)
+        float getSignedFloat();
+        // uniform float in [min, max)
+        float getFloat(float min, float max) { return min + (max - min) * getFloat(); }
+
+        // fills the result with uniform floats in [-1, 1)
+        void getSignedFloats(float* result, uint32_t count);
+
+        static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+        result_type operator()() { return getUInt32(); }
+
+    protected:
+        void step(uint32_t* result);
+
+        uint64_t seed;
+
+        // state[word][lane]
+        alignas(16) uint32_t state[4][LANE_COUNT];
+
+        uint32_t buffer[LANE_COUNT];
+        uint32_t bufferPosition = LANE_COUNT;
+    };
+}
@@ -9,5 +9,11 @@ namespace ouzel
     AnrdoidNEONChecker anrdoidNEONChecker;
 #endif
 
-    std::mt19937 randomEngine(std::random_device{}());
+    static uint64_t getRandomSeed()
+    {
+        std::random_device randomDevice;
+        return (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+    }
+
+    Random randomEngine(getRandomSeed());
 }
@@ -11,6 +11,7 @@
 #include <random>
 
 #include "core/CompileConfig.h"
+#include "utils/Random.h"
 #if OUZEL_PLATFORM_ANDROID
 #include <sstream>
 #include <cpu-features.h>
@@ -41,7 +42,7 @@ namespace ouzel
     extern AnrdoidNEONChecker anrdoidNEONChecker;
 #endif
 
-    extern std::mt19937 randomEngine;
+    extern Random randomEngine;
 
     template<typename T>
     size_t getVectorSize(const typename std::vector<T>& vec)